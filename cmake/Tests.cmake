@@ -14,16 +14,29 @@ macro(AddLo2sTest test_name)
 endmacro()
 
 AddLo2sTest(process_sampling)
+AddLo2sTest(callchain_cache)
+AddLo2sTest(sample_counters)
+AddLo2sTest(dwarf_unwinding)
+AddLo2sTest(memory_sampling)
 AddLo2sTest(process_counters)
+AddLo2sTest(metric_deltas)
+AddLo2sTest(counter_rotation)
 AddLo2sTest(predefined_counters)
 AddLo2sTest(userspace_counters)
 
 AddLo2sTest(system_sampling)
 AddLo2sTest(system_counters)
+AddLo2sTest(trace_rotation)
 
 AddLo2sTest(block_io)
 AddLo2sTest(tracepoint_recording)
 
+AddLo2sTest(trace_budget)
+AddLo2sTest(trace_size)
+AddLo2sTest(overhead_metrics)
+AddLo2sTest(streaming)
+AddLo2sTest(numa_placement)
+
 if(USE_LIBAUDIT)
     AddLo2sTest(syscall_recording)
 endif()
@@ -33,13 +46,27 @@ if(USE_SENSORS)
     AddLo2sTest(sensors_recording)
 endif()
 
+if(USE_X86_ENERGY)
+    AddLo2sTest(x86_energy)
+endif()
+
 if(USE_LIBPFM)
     AddLo2sTest(pfm_counters)
 endif()
 
+if(USE_DEBUGINFOD)
+    AddLo2sTest(debuginfod)
+endif()
+
 
 if(USE_BPF)
     AddLo2sTest(posix_io)
+    AddLo2sTest(off_cpu)
+endif()
+
+if(USE_BPF AND USE_LIBAUDIT)
+    AddLo2sTest(syscall_threshold)
+    AddLo2sTest(syscall_histograms)
 endif()
 
 if(USE_CUPTI)
@@ -47,3 +74,8 @@ if(USE_CUPTI)
 endif()
 
 AddLo2sTest(cli)
+
+add_test(NAME callchain_cache_lru COMMAND lo2s_callchain_cache_test)
+
+# Only checks that no events get lost, the throughput numbers are for humans
+add_test(NAME ringbuf_bench COMMAND lo2s_ringbuf_bench 100000 4)
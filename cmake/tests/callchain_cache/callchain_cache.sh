@@ -0,0 +1,40 @@
+#!/usr/bin/env bash
+
+# SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+
+set -euo pipefail
+
+SCRIPT_DIR=$(cd -- "$(dirname -- "${BASH_SOURCE[0]}")" &>/dev/null && pwd)
+
+if ! bash $SCRIPT_DIR/../paranoid.sh 2; then
+	echo "callchain cache test needs kernel.perf_event_paranoid=2" >&2
+	exit 127
+fi
+
+if ! bash $SCRIPT_DIR/../has_req_perf_events.sh; then
+	echo "callchain cache test needs access to the 'instructions' perf event!" >&2
+	exit 127
+fi
+
+rm -rf test_trace
+
+# Spends all its time in the same loop, so most samples have the same callchain
+output=$(./lo2s -vv -g --output-trace test_trace -- ./lo2s_unwind_target 2>&1)
+
+hits=$(grep -o "Callchain cache: [0-9]* hits" <<<"$output" | awk '{ sum += $3 } END { print sum + 0 }')
+if [ "$hits" -eq 0 ]; then
+	echo "Repeated callchains were never found in the callchain cache!"
+	exit 1
+fi
+
+contexts=$(otf2-print test_trace/traces.otf2 | sed -n 's/^CALLING_CONTEXT_SAMPLE.*Calling Context: \([^,]*\),.*/\1/p')
+num_samples=$(grep -c . <<<"$contexts" || true)
+num_contexts=$(sort -u <<<"$contexts" | grep -c . || true)
+
+# Samples of a cached callchain have to reference the very same calling context
+if [ "$num_samples" -eq 0 ] || [ "$num_contexts" -ge "$num_samples" ]; then
+	echo "$num_samples samples reference $num_contexts different calling contexts!"
+	exit 1
+fi
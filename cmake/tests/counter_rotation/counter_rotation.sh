@@ -0,0 +1,61 @@
+#!/usr/bin/env bash
+
+# SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+
+set -euo pipefail
+
+SCRIPT_DIR=$(cd -- "$(dirname -- "${BASH_SOURCE[0]}")" &>/dev/null && pwd)
+
+if ! bash $SCRIPT_DIR/../has_req_perf_events.sh; then
+	echo "Required perf events (instructions, cpu-cycles) for counter rotation test could not be found!"
+	exit 127
+fi
+
+# More events than any PMU has counters for, unknown ones are ignored
+events=""
+for ev in cpu-cycles instructions cache-references cache-misses branches branch-misses bus-cycles \
+	ref-cycles L1-dcache-loads L1-dcache-load-misses L1-dcache-stores L1-icache-load-misses \
+	LLC-loads LLC-load-misses LLC-stores LLC-store-misses dTLB-loads dTLB-load-misses dTLB-stores \
+	dTLB-store-misses iTLB-load-misses branch-loads branch-load-misses; do
+	events="$events -E $ev"
+done
+
+rm -rf test_trace
+
+./lo2s -v $events --metric-frequency 100 --output-trace test_trace -- bash -c "for i in \$(seq 500000); do true; done" 2>&1 | tee test_log.out
+
+groups=$(sed -n 's/.*counting \([0-9]*\) groups in turn.*/\1/p' test_log.out | head -n 1)
+if [ -z "$groups" ]; then
+	echo "The metric events fit into a single group, nothing to rotate!"
+	exit 127
+fi
+
+if ! otf2-print -G test_trace/traces.otf2 | grep "METRIC_MEMBER" | grep -q "\"active_group\""; then
+	echo "Trace does not contain the active group metric!"
+	exit 1
+fi
+
+otf2-print test_trace/traces.otf2 | grep "METRIC" | grep "\"active_group\"" >test_metrics.out
+
+# Every location reads out the groups in turn, and every group is read out
+if ! awk -v groups="$groups" '
+	match($0, /"active_group"[^)]*/) {
+		n = split(substr($0, RSTART, RLENGTH), value, "; ")
+		group = value[n] + 0
+		if (group < 0 || group >= groups || (($2 in last) && group != (last[$2] + 1) % groups)) bad = 1
+		last[$2] = group
+		seen[group] = 1
+	}
+	END { exit bad || length(seen) != groups }' test_metrics.out; then
+	echo "Trace does not contain readouts of the $groups groups in turn!"
+	exit 1
+fi
+
+# Only the first readout can see a group that was counting for the whole measurement
+if ! grep -o '"group_coverage"[^)]*' test_metrics.out | awk -F'; ' \
+	'$NF < 0 || $NF > 100 { bad = 1 } $NF < 100 { shared = 1 } END { exit bad || !shared }'; then
+	echo "Group coverage is not a share of the measurement!"
+	exit 1
+fi
@@ -0,0 +1,56 @@
+#!/usr/bin/env bash
+
+# SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+
+set -euo pipefail
+
+SCRIPT_DIR=$(cd -- "$(dirname -- "${BASH_SOURCE[0]}")" &>/dev/null && pwd)
+
+if ! bash $SCRIPT_DIR/../paranoid.sh 2; then
+	echo "debuginfod test needs kernel.perf_event_paranoid=2" >&2
+	exit 127
+fi
+
+if ! bash $SCRIPT_DIR/../has_req_perf_events.sh; then
+	echo "debuginfod test needs access to the 'instructions' perf event!" >&2
+	exit 127
+fi
+
+if ! command -v python3 >/dev/null; then
+	echo "debuginfod test needs python3 for the stand-in debuginfod server" >&2
+	exit 127
+fi
+
+rm -rf test_trace test_debuginfod test_debuginfod_cache test_debuginfod.log
+mkdir test_debuginfod test_debuginfod_cache
+
+# An empty debuginfod tree, every lookup is a miss
+python3 -u -m http.server 0 --bind 127.0.0.1 --directory test_debuginfod >test_debuginfod.log 2>&1 &
+SERVER=$!
+trap "kill $SERVER" EXIT
+
+PORT=""
+for i in $(seq 50); do
+	PORT=$(grep -oE "port [0-9]+" test_debuginfod.log | grep -oE "[0-9]+" || true)
+	if [ -n "$PORT" ]; then
+		break
+	fi
+	sleep 0.1
+done
+
+DEBUGINFOD_URLS="http://127.0.0.1:$PORT" DEBUGINFOD_CACHE_PATH="$PWD/test_debuginfod_cache" \
+	./lo2s -c 100000 --dwarf full --debuginfod-jobs 2 --output-trace test_trace -- seq 1000000 >/dev/null
+
+if ! otf2-print test_trace/traces.otf2 | grep "SAMPLE" >/dev/null; then
+	echo "Trace did not contain calling context samples!"
+	exit 1
+fi
+
+REPEATED=$(grep -oE "GET /buildid/[0-9a-f]+/debuginfo" test_debuginfod.log | sort | uniq -d)
+if [ -n "$REPEATED" ]; then
+	echo "Debug information was requested more than once:"
+	echo "$REPEATED"
+	exit 1
+fi
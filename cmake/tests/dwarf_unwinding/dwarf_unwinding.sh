@@ -0,0 +1,71 @@
+#!/usr/bin/env bash
+
+# SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+
+set -euo pipefail
+
+SCRIPT_DIR=$(cd -- "$(dirname -- "${BASH_SOURCE[0]}")" &>/dev/null && pwd)
+
+if ! bash $SCRIPT_DIR/../paranoid.sh 2; then
+	echo "DWARF unwinding test needs kernel.perf_event_paranoid=2" >&2
+	exit 127
+fi
+
+if ! bash $SCRIPT_DIR/../has_req_perf_events.sh; then
+	echo "DWARF unwinding test needs access to the 'instructions' perf event!" >&2
+	exit 127
+fi
+
+rm -rf test_trace
+
+# lo2s_unwind_target is built without frame pointers, the callchains of the kernel stop after its
+# leaf function
+./lo2s -c 100000 --dwarf-unwinding --output-trace test_trace -- ./lo2s_unwind_target
+
+if ! otf2-print test_trace/traces.otf2 | grep "SAMPLE" >/dev/null; then
+	echo "Trace did not contain calling context samples with DWARF unwinding!"
+	exit 1
+fi
+
+# Print the depth of the deepest calling context of lo2s_unwind_leaf, counting only the functions
+# of lo2s_unwind_target, by following the parents of the calling context definitions
+depth=$(otf2-print -G test_trace/traces.otf2 | awk '
+	$1 == "CALLING_CONTEXT" {
+		region[$2] = ""
+		if (match($0, /Region: "[^"]*"/)) {
+			region[$2] = substr($0, RSTART + 9, RLENGTH - 10)
+		}
+		parent[$2] = ""
+		if (match($0, /Parent: [^<]*<[0-9]+>/)) {
+			p = substr($0, RSTART, RLENGTH)
+			sub(/.*</, "", p)
+			sub(/>/, "", p)
+			parent[$2] = p
+		}
+	}
+	END {
+		max = 0
+		for (cctx in region) {
+			if (index(region[cctx], "lo2s_unwind_leaf") == 0) {
+				continue
+			}
+			depth = 0
+			for (c = cctx; c != ""; c = parent[c]) {
+				if (region[c] ~ /lo2s_unwind_(leaf|middle|outer)/ || region[c] == "main") {
+					depth++
+				}
+			}
+			if (depth > max) {
+				max = depth
+			}
+		}
+		print max
+	}')
+
+if [ "$depth" -le 1 ]; then
+	echo "Samples of lo2s_unwind_leaf were not unwound, call stack depth: $depth"
+	otf2-print -G test_trace/traces.otf2 | grep "CALLING_CONTEXT " || true
+	exit 1
+fi
@@ -13,9 +13,30 @@ rm -rf test_trace
 
 ./lo2s --no-instruction-sampling --output-trace test_trace --accel nvidia -- ./dummy_gpu_events
 
-if otf2-print test_trace/traces.otf2 | grep "foobar" >/dev/null; then
-	exit 0
-else
+if ! otf2-print test_trace/traces.otf2 | grep "foobar" >/dev/null; then
 	echo "Trace did not contain the \"foobar\" GPU event!"
 	exit 1
 fi
+
+rm -rf test_trace
+
+./lo2s --no-instruction-sampling --output-trace test_trace --accel nvidia -- ./dummy_gpu_events 10000
+
+if ! otf2-print test_trace/traces.otf2 | grep "fooqux" >/dev/null; then
+	echo "Trace did not contain the \"fooqux\" GPU event!"
+	exit 1
+fi
+
+rm -rf test_trace
+
+# Cycles more buffers than the pool keeps, so kernel names are reused at the same address
+./lo2s --no-instruction-sampling --output-trace test_trace --accel nvidia -- ./dummy_gpu_events --buffers 20
+
+for kernel in 0 1 2 3 4; do
+	if ! otf2-print -G test_trace/traces.otf2 | grep "buffer_kernel_$kernel" >/dev/null; then
+		echo "Trace did not contain the \"buffer_kernel_$kernel\" GPU event!"
+		exit 1
+	fi
+done
+
+exit 0
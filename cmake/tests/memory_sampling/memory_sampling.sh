@@ -0,0 +1,29 @@
+#!/usr/bin/env bash
+
+# SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+
+set -euo pipefail
+
+SCRIPT_DIR=$(cd -- "$(dirname -- "${BASH_SOURCE[0]}")" &>/dev/null && pwd)
+
+if ! bash $SCRIPT_DIR/../paranoid.sh 2; then
+	echo "memory sampling test needs kernel.perf_event_paranoid=2" >&2
+	exit 127
+fi
+
+rm -rf test_trace
+
+# Page faults are available everywhere and report the faulting address as data address
+./lo2s -e page-faults -c 1 --memory-sampling --output-trace test_trace -- dd if=/dev/zero of=/dev/null bs=4M count=4
+
+if ! otf2-print test_trace/traces.otf2 | grep "SAMPLE" >/dev/null; then
+	echo "Trace did not contain calling context samples!"
+	exit 1
+fi
+
+if ! otf2-print -G test_trace/traces.otf2 | grep "data::" | grep "::samples" >/dev/null; then
+	echo "Trace does not contain the data object calling context properties!"
+	exit 1
+fi
@@ -0,0 +1,38 @@
+#!/usr/bin/env bash
+
+# SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+
+set -euo pipefail
+
+SCRIPT_DIR=$(cd -- "$(dirname -- "${BASH_SOURCE[0]}")" &>/dev/null && pwd)
+
+if ! bash $SCRIPT_DIR/../has_req_perf_events.sh; then
+	echo "Required perf events (instructions, cpu-cycles) for metric deltas test could not be found!"
+	exit 127
+fi
+
+rm -rf test_trace
+
+./lo2s --metric-deltas --metric-frequency 100 --standard-metrics --output-trace test_trace -- bash -c "for i in \$(seq 100000); do true; done"
+
+if ! otf2-print test_trace/traces.otf2 | grep "METRIC" | grep "cpu-cycles" >/dev/null; then
+	echo "Trace does not contain counter metrics with --metric-deltas!"
+	exit 1
+fi
+
+if ! otf2-print -G test_trace/traces.otf2 | grep "METRIC_MEMBER" | grep "ACCUMULATED_LAST" >/dev/null; then
+	echo "Counter metrics are not marked as accumulated since the last event!"
+	exit 1
+fi
+
+rm -rf test_trace
+
+# No counter changes by that much, so only the final event is written
+./lo2s --metric-deltas --metric-delta-threshold 1e18 --metric-frequency 100 --standard-metrics --output-trace test_trace -- bash -c "for i in \$(seq 100000); do true; done"
+
+if ! otf2-print test_trace/traces.otf2 | grep "METRIC" | grep "cpu-cycles" >/dev/null; then
+	echo "Trace does not contain the final counter metric event with --metric-delta-threshold!"
+	exit 1
+fi
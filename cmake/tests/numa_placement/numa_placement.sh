@@ -0,0 +1,76 @@
+#!/usr/bin/env bash
+
+# SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+
+set -euo pipefail
+
+SCRIPT_DIR=$(cd -- "$(dirname -- "${BASH_SOURCE[0]}")" &>/dev/null && pwd)
+
+if ! bash $SCRIPT_DIR/../has_req_perf_events.sh; then
+	echo "Required perf events (instructions, cpu-cycles) for NUMA placement test could not be found!"
+	exit 127
+fi
+
+if ! command -v taskset >/dev/null; then
+	echo "taskset is required for the NUMA placement test!"
+	exit 127
+fi
+
+# The CPUs we may run on
+allowed=$(taskset -pc $$ | sed 's/.*: //')
+cpus=()
+IFS=, read -ra ranges <<<"$allowed"
+for range in "${ranges[@]}"; do
+	for ((cpu = ${range%-*}; cpu <= ${range#*-}; cpu++)); do
+		cpus+=("$cpu")
+	done
+done
+
+if [ ${#cpus[@]} -lt 2 ]; then
+	echo "The NUMA placement test needs at least two CPUs!"
+	exit 127
+fi
+
+# Fake a topology with the first CPU on node 0 and all others on node 1
+rm -rf test_numa
+mkdir -p test_numa/node0 test_numa/node1
+echo "0-1" >test_numa/online
+echo "${cpus[0]}" >test_numa/node0/cpulist
+cat /sys/devices/system/cpu/online >test_numa/node1/cpulist
+# A CPU may be listed on two nodes, the first one wins
+export LO2S_TEST_NUMA_SYSFS=$(pwd)/test_numa
+
+# Prints the NUMA node lo2s determines for the thread running on the given CPUs
+numa_node_on() {
+	rm -rf test_trace
+	output=$(taskset -c "$1" ./lo2s -vv --output-trace test_trace "${@:2}" -- true 2>&1)
+	if [[ $output =~ NUMA\ node\ of\ thread\ [0-9]+:\ (-?[0-9]+) ]]; then
+		echo "${BASH_REMATCH[1]}"
+	fi
+}
+
+node=$(numa_node_on "${cpus[0]}")
+if [ "$node" != "0" ]; then
+	echo "Thread pinned to the CPU of node 0 is placed on node '$node'!"
+	exit 1
+fi
+
+node=$(numa_node_on "${cpus[1]}")
+if [ "$node" != "1" ]; then
+	echo "Thread pinned to a CPU of node 1 is placed on node '$node'!"
+	exit 1
+fi
+
+node=$(numa_node_on "${cpus[0]},${cpus[1]}")
+if [ "$node" != "-1" ]; then
+	echo "Thread spanning both nodes is placed on node '$node'!"
+	exit 1
+fi
+
+node=$(numa_node_on "${cpus[0]}" --no-numa-placement)
+if [ -n "$node" ]; then
+	echo "Thread is placed on node '$node' despite --no-numa-placement!"
+	exit 1
+fi
@@ -0,0 +1,26 @@
+#!/usr/bin/env bash
+
+# SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+
+set -euo pipefail
+
+if ! test $UID = 0; then
+	echo "The off-CPU test needs superuser rights"
+	exit 127
+fi
+
+rm -rf test_trace
+
+./lo2s --off-cpu --off-cpu-threshold 1000 -o test_trace -- bash -c "sleep 0.1; sleep 0.1"
+
+if ! otf2-print -G test_trace/traces.otf2 | grep "off-CPU events" >/dev/null; then
+	echo "Trace does not contain an off-CPU location!"
+	exit 1
+fi
+
+if ! otf2-print test_trace/traces.otf2 | grep "CALLING_CONTEXT_ENTER" >/dev/null; then
+	echo "Trace does not contain any blocked intervals!"
+	exit 1
+fi
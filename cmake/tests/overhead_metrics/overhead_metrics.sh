@@ -0,0 +1,42 @@
+#!/usr/bin/env bash
+
+# SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+
+set -euo pipefail
+
+SCRIPT_DIR=$(cd -- "$(dirname -- "${BASH_SOURCE[0]}")" &>/dev/null && pwd)
+
+if ! bash $SCRIPT_DIR/../has_req_perf_events.sh; then
+	echo "Required perf events (instructions, cpu-cycles) for overhead metrics test could not be found!"
+	exit 127
+fi
+
+rm -rf test_trace
+
+# The overhead metrics are written once per second
+./lo2s --overhead-metrics --output-trace test_trace -- sleep 3
+
+definitions=$(otf2-print -G test_trace/traces.otf2)
+
+for member in "wakeups" "records per drain" "drain latency" "bytes written" "cpu usage" "buffer fill"; do
+	if ! grep "METRIC_MEMBER" <<<"$definitions" | grep -q "\"$member\""; then
+		echo "Trace does not contain the \"$member\" overhead metric!"
+		exit 1
+	fi
+done
+
+# Locations of the "<monitor> overhead" metrics
+locations=$(awk '$1 == "LOCATION" && /overhead"/ { print $2 }' <<<"$definitions")
+if [ -z "$locations" ]; then
+	echo "Trace does not contain any overhead metric locations!"
+	exit 1
+fi
+
+if ! otf2-print test_trace/traces.otf2 |
+	awk -v locations="$locations" 'BEGIN { split(locations, ids) ; for (i in ids) overhead[ids[i]] = 1 }
+		$1 == "METRIC" && ($2 in overhead) { found = 1 } END { exit !found }'; then
+	echo "Trace does not contain any overhead metric events!"
+	exit 1
+fi
@@ -0,0 +1,33 @@
+#!/usr/bin/env bash
+
+# SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+
+set -euo pipefail
+
+SCRIPT_DIR=$(cd -- "$(dirname -- "${BASH_SOURCE[0]}")" &>/dev/null && pwd)
+
+if ! bash $SCRIPT_DIR/../paranoid.sh 2; then
+	echo "sample counters test needs kernel.perf_event_paranoid=2" >&2
+	exit 127
+fi
+
+if ! bash $SCRIPT_DIR/../has_req_perf_events.sh; then
+	echo "sample counters test needs access to the 'instructions' perf event!" >&2
+	exit 127
+fi
+
+rm -rf test_trace
+
+./lo2s -c 100000 --sample-counter instructions --output-trace test_trace -- bash -c "for i in \$(seq 1000); do true; done"
+
+if ! otf2-print test_trace/traces.otf2 | grep "SAMPLE" >/dev/null; then
+	echo "Trace did not contain calling context samples!"
+	exit 1
+fi
+
+if ! otf2-print -G test_trace/traces.otf2 | grep "counter::instructions" >/dev/null; then
+	echo "Trace does not contain the sample counter calling context properties!"
+	exit 1
+fi
@@ -21,9 +21,44 @@ rm -rf test_trace
 
 sensor=$(sensors | head -n 1)
 
-if otf2-print test_trace/traces.otf2 | grep "METRIC" | grep ${sensor} >/dev/null; then
-	exit 0
-else
+if ! otf2-print test_trace/traces.otf2 | grep "METRIC" | grep ${sensor} >/dev/null; then
 	echo "Trace did not contain any sensor readings!"
 	exit 1
 fi
+
+rm -rf test_trace
+
+# Read the first sensor at its own interval and all others at another one
+output=$(./lo2s -vv --no-instruction-sampling -S -o test_trace -- true 2>&1)
+if ! [[ $output =~ Found\ sensor:\ ([^$'\n']*) ]]; then
+	echo "No sensors found by lo2s!"
+	exit 1
+fi
+first_sensor=${BASH_REMATCH[1]}
+num_sensors=$(grep -c "Found sensor:" <<<"$output")
+
+rm -rf test_trace
+
+output=$(./lo2s -vv --no-instruction-sampling --sensor "${first_sensor}@50" --sensor "@200" -o test_trace -- sleep 1 2>&1)
+
+if ! grep -q "Reading 1 sensors every 50 ms" <<<"$output"; then
+	echo "The selected sensor is not read at its own interval!"
+	exit 1
+fi
+
+if [ "$num_sensors" -gt 1 ] && ! grep -q "sensors every 200 ms" <<<"$output"; then
+	echo "The other sensors are not read at the second interval!"
+	exit 1
+fi
+
+# Sensors are read from their hwmon file unless that does not match libsensors, e.g. because of
+# compute statements in sensors.conf, so either way is fine here as long as one was chosen
+if ! grep -Eq "Reading .* (with pread\(\)|through libsensors)" <<<"$output"; then
+	echo "lo2s did not decide how to read the sensors!"
+	exit 1
+fi
+
+if ! otf2-print test_trace/traces.otf2 | grep "METRIC" | grep ${sensor} >/dev/null; then
+	echo "Trace did not contain any readings of the selected sensors!"
+	exit 1
+fi
@@ -0,0 +1,43 @@
+#!/usr/bin/env bash
+
+# SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+
+set -euo pipefail
+
+SCRIPT_DIR=$(cd -- "$(dirname -- "${BASH_SOURCE[0]}")" &>/dev/null && pwd)
+
+if ! bash $SCRIPT_DIR/../paranoid.sh 2; then
+	echo "streaming test needs kernel.perf_event_paranoid=2" >&2
+	exit 127
+fi
+
+if ! bash $SCRIPT_DIR/../has_req_perf_events.sh; then
+	echo "streaming test needs access to the 'instructions' perf event!" >&2
+	exit 127
+fi
+
+rm -rf test_trace test_stream.sock test_stream.out
+
+./lo2s_stream_consumer test_stream.sock 1 >test_stream.out &
+CONSUMER=$!
+
+for i in $(seq 50); do
+	if [ -S test_stream.sock ]; then
+		break
+	fi
+	sleep 0.1
+done
+
+./lo2s -c 100000 --stream test_stream.sock --output-trace test_trace -- seq 1000000 >/dev/null
+
+wait $CONSUMER
+
+if grep -E "^samples: [1-9]" test_stream.out >/dev/null; then
+	exit 0
+else
+	echo "Stream consumer did not receive any samples!"
+	cat test_stream.out
+	exit 1
+fi
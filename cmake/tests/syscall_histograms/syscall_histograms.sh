@@ -0,0 +1,31 @@
+#!/usr/bin/env bash
+
+# SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+
+set -euo pipefail
+
+if ! test $UID = 0; then
+	echo "The syscall histograms test needs superuser rights"
+	exit 127
+fi
+
+rm -rf test_trace
+
+./lo2s -s write --syscall-histograms --syscall-histogram-interval 100 -o test_trace -- bash -c "for i in \$(seq 100); do echo FOOBAR; done; sleep 0.3"
+
+if otf2-print test_trace/traces.otf2 | grep "ENTER" | grep "write" >/dev/null; then
+	echo "Trace contains write() syscall events instead of only histograms!"
+	exit 1
+fi
+
+if ! otf2-print -G test_trace/traces.otf2 | grep "write::count" >/dev/null; then
+	echo "Trace does not contain the write() syscall histogram!"
+	exit 1
+fi
+
+if ! otf2-print test_trace/traces.otf2 | grep "METRIC" >/dev/null; then
+	echo "Trace does not contain any syscall metrics!"
+	exit 1
+fi
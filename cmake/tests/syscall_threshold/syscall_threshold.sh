@@ -0,0 +1,27 @@
+#!/usr/bin/env bash
+
+# SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+
+set -euo pipefail
+
+if ! test $UID = 0; then
+	echo "The syscall threshold test needs superuser rights"
+	exit 127
+fi
+
+rm -rf test_trace
+
+# The sleep is slow, the write of echo is not
+./lo2s -s all --syscall-threshold 50000 -o test_trace -- bash -c "sleep 0.2; echo FOOBAR"
+
+if ! otf2-print test_trace/traces.otf2 | grep "ENTER" | grep "nanosleep" >/dev/null; then
+	echo "Trace does not contain the slow nanosleep() syscall!"
+	exit 1
+fi
+
+if otf2-print test_trace/traces.otf2 | grep "ENTER" | grep "write" >/dev/null; then
+	echo "Trace contains the fast write() syscall!"
+	exit 1
+fi
@@ -0,0 +1,35 @@
+#!/usr/bin/env bash
+
+# SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+
+set -euo pipefail
+
+SCRIPT_DIR=$(cd -- "$(dirname -- "${BASH_SOURCE[0]}")" &>/dev/null && pwd)
+
+if ! bash $SCRIPT_DIR/../paranoid.sh 2; then
+	echo "trace budget test needs kernel.perf_event_paranoid=2" >&2
+	exit 127
+fi
+
+if ! bash $SCRIPT_DIR/../has_req_perf_events.sh; then
+	echo "trace budget test needs access to the 'instructions' perf event!" >&2
+	exit 127
+fi
+
+rm -rf test_trace
+
+./lo2s -c 10000 --max-trace-size 1 --output-trace test_trace -- seq 100000000 >/dev/null
+
+if ! otf2-print -G test_trace/traces.otf2 | grep "TRACE_BUDGET::MAX_DEGRADATION" >/dev/null; then
+	echo "Trace does not contain the trace budget properties!"
+	exit 1
+fi
+
+if otf2-print -G test_trace/traces.otf2 | grep "TRACE_BUDGET::MAX_DEGRADATION" | grep "none" >/dev/null; then
+	echo "lo2s did not degrade the recording when exceeding the trace budget!"
+	exit 1
+fi
+
+exit 0
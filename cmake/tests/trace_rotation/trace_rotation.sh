@@ -0,0 +1,59 @@
+#!/usr/bin/env bash
+
+# SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+
+set -euo pipefail
+
+SCRIPT_DIR=$(cd -- "$(dirname -- "${BASH_SOURCE[0]}")" &>/dev/null && pwd)
+
+if ! bash $SCRIPT_DIR/../paranoid.sh 0; then
+	echo "trace rotation test needs kernel.perf_event_paranoid=0" >&2
+	exit 127
+fi
+
+if ! bash $SCRIPT_DIR/../has_req_perf_events.sh; then
+	echo "trace rotation test needs access to the 'instructions' perf event!" >&2
+	exit 127
+fi
+
+rm -rf test_trace_*
+
+# Keep one CPU busy, so that there are samples right before and after every rotation
+(while :; do :; done) &
+busy_pid=$!
+trap "kill $busy_pid" EXIT
+
+./lo2s -A -c 100000 --rotate-interval 1 --output-trace test_trace &
+lo2s_pid=$!
+sleep 4
+kill -INT $lo2s_pid
+wait $lo2s_pid
+
+traces=(test_trace_*)
+if [ ${#traces[@]} -lt 3 ]; then
+	echo "Expected at least 3 rotated traces, got: ${traces[*]}"
+	exit 1
+fi
+
+# The perf events are handed over between the traces, so every trace has to start where the
+# previous one ended. Allow 10 ms (in ns ticks) between the last sample of a trace and the
+# first sample of the next one.
+previous_last=""
+for trace in "${traces[@]}"; do
+	timestamps=$(otf2-print $trace/traces.otf2 | awk '$1 == "CALLING_CONTEXT_SAMPLE" { print $3 }' | sort -n)
+	if [ -z "$timestamps" ]; then
+		echo "$trace does not contain any samples!"
+		exit 1
+	fi
+
+	first=$(echo "$timestamps" | head -n 1)
+	if [ -n "$previous_last" ] && [ $((first - previous_last)) -gt 10000000 ]; then
+		echo "Gap of $((first - previous_last)) ns before the first sample of $trace!"
+		exit 1
+	fi
+	previous_last=$(echo "$timestamps" | tail -n 1)
+done
+
+exit 0
@@ -0,0 +1,46 @@
+#!/usr/bin/env bash
+
+# SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+
+set -euo pipefail
+
+SCRIPT_DIR=$(cd -- "$(dirname -- "${BASH_SOURCE[0]}")" &>/dev/null && pwd)
+
+if ! bash $SCRIPT_DIR/../paranoid.sh 2; then
+	echo "trace size test needs kernel.perf_event_paranoid=2" >&2
+	exit 127
+fi
+
+if ! bash $SCRIPT_DIR/../has_req_perf_events.sh; then
+	echo "trace size test needs access to the 'instructions' perf event!" >&2
+	exit 127
+fi
+
+rm -rf test_trace
+
+reported=$(./lo2s --output-trace test_trace -- seq 1000000 2>/dev/null | grep -o "wrote [0-9.]* [KMGT]\?i\?B")
+# The summary counts the event and definition files, which OTF2 writes through its buffers
+on_disk=$(find test_trace -type f \( -name "*.evt" -o -name "*.def" \) -printf "%s\n" | awk '{ sum += $1 } END { print sum }')
+
+# The summary prints the size with two decimal places of the largest fitting unit
+reported_bytes=$(echo "$reported" | awk '{
+	split("B KiB MiB GiB TiB", units, " ")
+	for (i = 1; i <= 5; i++) {
+		if ($3 == units[i]) {
+			printf "%d\n", $2 * 1024 ^ (i - 1)
+		}
+	}
+}')
+
+if ! awk -v reported="$reported_bytes" -v on_disk="$on_disk" 'BEGIN {
+	diff = reported - on_disk
+	if (diff < 0) diff = -diff
+	exit !(diff <= on_disk / 100 + 1)
+}'; then
+	echo "Summary reports \"$reported\" ($reported_bytes bytes), but the trace has $on_disk bytes on disk!"
+	exit 1
+fi
+
+exit 0
@@ -0,0 +1,48 @@
+#!/usr/bin/env bash
+
+# SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+
+set -euo pipefail
+
+rm -rf test_trace
+
+if ./lo2s -X --x86-energy-read-interval 0 --output-trace test_trace -- true >/dev/null 2>&1; then
+	echo "--x86-energy-read-interval 0 was accepted!"
+	exit 1
+fi
+
+if ./lo2s -X --x86-energy-cpu 100000 --output-trace test_trace -- true >/dev/null 2>&1; then
+	echo "--x86-energy-cpu with an unknown cpu was accepted!"
+	exit 1
+fi
+
+rm -rf test_trace
+
+output=$(./lo2s -vv -X --x86-energy-single-thread --output-trace test_trace -- sleep 1 2>&1 || true)
+
+if ! grep -q "Using x86_energy access source" <<<"$output"; then
+	echo "No x86_energy access source (e.g. RAPL) available" >&2
+	exit 127
+fi
+
+if [ "$(grep -c "x86_energy monitor starting" <<<"$output")" -ne 1 ]; then
+	echo "--x86-energy-single-thread did not start exactly one x86_energy monitor!"
+	exit 1
+fi
+
+rm -rf test_trace
+
+cpu=$(cut -d, -f1 /sys/devices/system/cpu/online | cut -d- -f1)
+output=$(./lo2s -vv -X --x86-energy-cpu "$cpu" --output-trace test_trace -- sleep 1 2>&1)
+
+if [ "$(grep -c "x86_energy monitor starting" <<<"$output")" -ne 1 ]; then
+	echo "--x86-energy-cpu did not imply --x86-energy-single-thread!"
+	exit 1
+fi
+
+if ! otf2-print test_trace/traces.otf2 | grep -q "METRIC"; then
+	echo "Trace does not contain any x86_energy readings!"
+	exit 1
+fi
@@ -0,0 +1,72 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Checks the lookup and the LRU eviction of the CallchainCache with a small capacity.
+
+#include <lo2s/callchain_cache.hpp>
+#include <lo2s/calling_context.hpp>
+
+#include <iostream>
+
+#include <cstdint>
+#include <cstdlib>
+
+namespace
+{
+int failures = 0;
+
+void check(bool condition, const char* what)
+{
+    if (!condition)
+    {
+        std::cerr << "FAILED: " << what << "\n";
+        failures++;
+    }
+}
+
+lo2s::LocalCctxMap::value_type* add_node(lo2s::LocalCctxMap& tree, uint64_t ip)
+{
+    return &*tree.emplace(lo2s::CallingContext::sample(ip), lo2s::LocalCctxNode(ip)).first;
+}
+} // namespace
+
+int main()
+{
+    // The cache only compares the node pointers, the nodes do not have to form a tree
+    lo2s::LocalCctxMap tree;
+    auto* parent = add_node(tree, 1);
+    auto* leaf_a = add_node(tree, 2);
+    auto* leaf_b = add_node(tree, 3);
+    auto* leaf_c = add_node(tree, 4);
+
+    const uint64_t a[] = { 0, 10, 11 };
+    const uint64_t b[] = { 0, 20, 21 };
+    const uint64_t c[] = { 0, 30, 31 };
+
+    lo2s::CallchainCache cache(2);
+
+    check(cache.find(parent, 3, a) == nullptr, "lookup in an empty cache misses");
+
+    cache.insert(parent, 3, a, leaf_a);
+    cache.insert(parent, 3, b, leaf_b);
+    check(cache.find(parent, 3, a) == leaf_a, "inserted callchain is found");
+
+    // a was used more recently than b, so b has to make room for c
+    cache.insert(parent, 3, c, leaf_c);
+    check(cache.find(parent, 3, b) == nullptr, "least recently used callchain is evicted");
+    check(cache.find(parent, 3, a) == leaf_a, "recently used callchain is kept");
+    check(cache.find(parent, 3, c) == leaf_c, "newly inserted callchain is found");
+
+    check(cache.find(leaf_a, 3, a) == nullptr, "callchain below another node misses");
+    check(cache.find(parent, 2, a) == nullptr, "prefix of a callchain misses");
+
+    check(cache.hits() == 3, "hits are counted");
+    check(cache.misses() == 4, "misses are counted");
+
+    lo2s::CallchainCache disabled(0);
+    disabled.insert(parent, 3, a, leaf_a);
+    check(disabled.find(parent, 3, a) == nullptr, "cache without capacity stores nothing");
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
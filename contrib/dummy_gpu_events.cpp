@@ -2,20 +2,79 @@
 //
 // SPDX-License-Identifier: GPL-3.0-or-later
 
+#include <lo2s/gpu/buffer_pool.hpp>
 #include <lo2s/gpu/ringbuf.hpp>
 #include <lo2s/types/process.hpp>
 
 #include <memory>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 
 extern "C"
 {
 #include <unistd.h>
 }
 
-int main()
+// Stand-in for a CUDA application: writes a single long "foobar" kernel, or, if a number N is
+// given, N short kernels with names shared between the records like CUPTI does.
+//
+// With "--buffers N", N activity buffers are cycled through a pool that keeps only two of them,
+// like the CUDA injection library does. The kernel names are stored inside of the buffers, so
+// the same name address is reused for different kernels.
+int main(int argc, char** argv)
 {
     auto rb_writer = std::make_unique<lo2s::gpu::RingbufWriter>(lo2s::Process::me());
-    uint64_t cctx = rb_writer->kernel_def("foobar");
-    rb_writer->kernel(rb_writer->timestamp(), rb_writer->timestamp() + 100000000, cctx);
+
+    if (argc < 2)
+    {
+        uint64_t cctx = rb_writer->kernel_def("foobar");
+        rb_writer->kernel(rb_writer->timestamp(), rb_writer->timestamp() + 100000000, cctx);
+        return 0;
+    }
+
+    if (argc == 3 && std::string(argv[1]) == "--buffers")
+    {
+        // Like CUPTI, have more buffers in use at the same time than the pool keeps
+        constexpr uint64_t IN_FLIGHT = 4;
+        lo2s::gpu::BufferPool pool(64, 2);
+
+        uint64_t num_buffers = std::strtoull(argv[2], nullptr, 10);
+        for (uint64_t i = 0; i < num_buffers; i += IN_FLIGHT)
+        {
+            std::vector<uint8_t*> buffers;
+            for (uint64_t j = i; j < i + IN_FLIGHT && j < num_buffers; j++)
+            {
+                auto* buffer = buffers.emplace_back(pool.get());
+                auto* name = reinterpret_cast<char*>(buffer);
+                std::snprintf(name, pool.buffer_size(), "buffer_kernel_%lu",
+                              static_cast<unsigned long>(j % 5));
+
+                uint64_t cctx = rb_writer->kernel_def(name);
+                auto start = rb_writer->timestamp();
+                rb_writer->kernel(start, start + 1000, cctx);
+            }
+
+            for (auto* buffer : buffers)
+            {
+                pool.put(buffer);
+            }
+        }
+        return 0;
+    }
+
+    static const char* names[] = { "foobar", "foobaz", "fooqux" };
+
+    uint64_t num_kernels = std::strtoull(argv[1], nullptr, 10);
+    for (uint64_t i = 0; i < num_kernels; i++)
+    {
+        const char* name = names[i % 3];
+        uint64_t cctx = rb_writer->kernel_def(name);
+        auto start = rb_writer->timestamp();
+        rb_writer->kernel(start, start + 1000, cctx);
+    }
     return 0;
 }
@@ -0,0 +1,437 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Throughput benchmark for the shared memory ring-buffer between the injection libraries
+// (CUPTI, HIP, OMPT) and lo2s.
+//
+// Every scenario connects a real RingbufWriter to a RingbufReader through the same socket
+// handshake lo2s uses and drains the ring-buffer from a separate consumer thread, as the
+// GPUMonitor and OpenMPMonitor do. Producers retry if the ring-buffer is full, so the numbers show
+// the sustained throughput of the writer and reader together. The reserve latency is the time of a
+// single successful write call, i.e. reserve() and commit() including the locking of the OMPT
+// writer. Unsuccessful calls, because the ring-buffer was full, are counted as retries.
+// Waiting producers and the idle consumer yield, so the benchmark also works with fewer cores than
+// threads. It fails if the consumer did not see all written events.
+//
+// Usage: lo2s_ringbuf_bench [EVENTS [THREADS]]
+
+#include <lo2s/gpu/ringbuf.hpp>
+#include <lo2s/ompt/events.hpp>
+#include <lo2s/ompt/ringbuf.hpp>
+#include <lo2s/rb/events.hpp>
+#include <lo2s/rb/header.hpp>
+#include <lo2s/rb/reader.hpp>
+#include <lo2s/rb/writer.hpp>
+#include <lo2s/types/process.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+extern "C"
+{
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+}
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+struct bench_event
+{
+    struct lo2s::event_header header;
+    uint64_t value;
+};
+
+std::string socket_path;
+
+// Plays the part of the lo2s SocketMonitor: hands the ring-buffer of `reader` to the next writer
+// that connects.
+class Handshake
+{
+public:
+    Handshake(lo2s::RingbufReader& reader) : reader_(reader)
+    {
+        socket_ = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+        if (socket_ == -1)
+        {
+            throw std::system_error(errno, std::system_category());
+        }
+
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+
+        unlink(socket_path.c_str());
+        if (bind(socket_, reinterpret_cast<const struct sockaddr*>(&addr), sizeof(addr)) == -1 ||
+            listen(socket_, 1) == -1)
+        {
+            throw std::system_error(errno, std::system_category());
+        }
+
+        thread_ = std::thread([this]() { serve(); });
+    }
+
+    ~Handshake()
+    {
+        thread_.join();
+        close(socket_);
+        unlink(socket_path.c_str());
+    }
+
+private:
+    void serve()
+    {
+        int data_socket = accept(socket_, nullptr, nullptr);
+        if (data_socket == -1)
+        {
+            throw std::system_error(errno, std::system_category());
+        }
+
+        union
+        {
+            struct cmsghdr cm;
+            char control[CMSG_SPACE(sizeof(int))];
+        } control_un;
+
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_control = control_un.control;
+        msg.msg_controllen = sizeof(control_un.control);
+
+        struct cmsghdr* cmptr = CMSG_FIRSTHDR(&msg);
+        cmptr->cmsg_len = CMSG_LEN(sizeof(int));
+        cmptr->cmsg_level = SOL_SOCKET;
+        cmptr->cmsg_type = SCM_RIGHTS;
+
+        int send_fd = reader_.fd();
+        memcpy(CMSG_DATA(cmptr), &send_fd, sizeof(int));
+
+        uint64_t payload = 42;
+        struct iovec iov[1];
+        iov[0].iov_base = &payload;
+        iov[0].iov_len = sizeof(payload);
+        msg.msg_iov = iov;
+        msg.msg_iovlen = 1;
+
+        if (sendmsg(data_socket, &msg, 0) == -1)
+        {
+            throw std::system_error(errno, std::system_category());
+        }
+        close(data_socket);
+    }
+
+    lo2s::RingbufReader& reader_;
+    int socket_;
+    std::thread thread_;
+};
+
+// Drains the ring-buffer until all producers are done and it is empty.
+class Consumer
+{
+public:
+    Consumer(lo2s::RingbufReader& reader) : reader_(reader)
+    {
+        thread_ = std::thread([this]() { run(); });
+    }
+
+    void finish()
+    {
+        done_ = true;
+        thread_.join();
+    }
+
+    uint64_t events() const
+    {
+        return events_;
+    }
+
+    uint64_t bytes() const
+    {
+        return bytes_;
+    }
+
+private:
+    void run()
+    {
+        while (true)
+        {
+            // Read done_ before checking for emptiness, so no event committed before the
+            // producers finished is missed.
+            bool const done = done_;
+            if (reader_.empty())
+            {
+                if (done)
+                {
+                    return;
+                }
+                std::this_thread::yield();
+                continue;
+            }
+
+            const auto* ev = reader_.get<struct lo2s::event_header>();
+            bytes_ += ev->size;
+            events_++;
+            reader_.pop();
+        }
+    }
+
+    lo2s::RingbufReader& reader_;
+    std::atomic<bool> done_ = false;
+    uint64_t events_ = 0;
+    uint64_t bytes_ = 0;
+    std::thread thread_;
+};
+
+struct ProducerResult
+{
+    std::vector<uint64_t> latencies;
+    uint64_t retries = 0;
+};
+
+// Calls `write` until it succeeded `count` times, recording the latency of the successful calls
+template <class F>
+void produce(uint64_t count, ProducerResult& result, F&& write)
+{
+    result.latencies.reserve(count);
+    for (uint64_t i = 0; i < count; i++)
+    {
+        while (true)
+        {
+            auto start = Clock::now();
+            bool const success = write(i);
+            auto end = Clock::now();
+
+            if (success)
+            {
+                result.latencies.emplace_back(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+                break;
+            }
+            result.retries++;
+            std::this_thread::yield();
+        }
+    }
+}
+
+// Prints the results, returns false if the consumer did not see every written event
+bool report(const std::string& name, Clock::duration duration, const Consumer& consumer,
+            std::vector<ProducerResult>& results)
+{
+    std::vector<uint64_t> latencies;
+    uint64_t retries = 0;
+    for (auto& result : results)
+    {
+        latencies.insert(latencies.end(), result.latencies.begin(), result.latencies.end());
+        retries += result.retries;
+    }
+
+    uint64_t p99 = 0;
+    if (!latencies.empty())
+    {
+        auto p99_it = latencies.begin() + (latencies.size() * 99 / 100);
+        std::nth_element(latencies.begin(), p99_it, latencies.end());
+        p99 = *p99_it;
+    }
+
+    double const seconds = std::chrono::duration<double>(duration).count();
+    std::cout << std::left << std::setw(28) << name << std::right << std::setw(12)
+              << consumer.events() << std::setw(14) << std::fixed << std::setprecision(0)
+              << consumer.events() / seconds << std::setw(12) << std::setprecision(1)
+              << consumer.bytes() / seconds / (1024 * 1024) << std::setw(10) << p99
+              << std::setw(12) << retries << "\n";
+
+    // Writers may write more events than they were called for (kernel definitions), never less
+    if (consumer.events() < latencies.size())
+    {
+        std::cerr << name << ": lost " << latencies.size() - consumer.events() << " events!\n";
+        return false;
+    }
+    return true;
+}
+
+// Runs `threads` producers, each given its index and its ProducerResult. The writer has to be
+// created by `setup` while the handshake is waiting, i.e. before the producers start.
+template <class Writer>
+bool run(const std::string& name, std::size_t threads,
+         const std::function<std::unique_ptr<Writer>()>& setup,
+         const std::function<void(Writer&, std::size_t, ProducerResult&)>& producer)
+{
+    lo2s::RingbufReader reader(CLOCK_MONOTONIC);
+
+    std::unique_ptr<Writer> writer;
+    {
+        Handshake const handshake(reader);
+        writer = setup();
+    }
+
+    Consumer consumer(reader);
+    std::vector<ProducerResult> results(threads);
+    std::vector<std::thread> producers;
+
+    auto start = Clock::now();
+    for (std::size_t i = 0; i < threads; i++)
+    {
+        producers.emplace_back([&, i]() { producer(*writer, i, results[i]); });
+    }
+    for (auto& thread : producers)
+    {
+        thread.join();
+    }
+    consumer.finish();
+    auto duration = Clock::now() - start;
+
+    return report(name, duration, consumer, results);
+}
+
+bool fixed_size(uint64_t events)
+{
+    return run<lo2s::RingbufWriter>(
+        "fixed 24 B",
+        1,
+        []() {
+            return std::make_unique<lo2s::RingbufWriter>(lo2s::Process::me(),
+                                                         lo2s::RingbufMeasurementType::GPU);
+        },
+        [events](lo2s::RingbufWriter& writer, std::size_t, ProducerResult& result) {
+            produce(events, result, [&writer](uint64_t i) {
+                auto* ev = writer.reserve<bench_event>();
+                if (ev == nullptr)
+                {
+                    return false;
+                }
+                ev->value = i;
+                writer.commit();
+                return true;
+            });
+        });
+}
+
+// Random payloads between 0 and 1 KiB, so that events regularly wrap around the end of the
+// ring-buffer at varying offsets.
+bool variable_size(uint64_t events)
+{
+    return run<lo2s::RingbufWriter>(
+        "variable 24 B - 1 KiB",
+        1,
+        []() {
+            return std::make_unique<lo2s::RingbufWriter>(lo2s::Process::me(),
+                                                         lo2s::RingbufMeasurementType::GPU);
+        },
+        [events](lo2s::RingbufWriter& writer, std::size_t, ProducerResult& result) {
+            std::mt19937_64 rng(42);
+            std::uniform_int_distribution<uint64_t> payload_size(0, 1024);
+
+            uint64_t payload = payload_size(rng);
+            produce(events, result, [&](uint64_t i) {
+                auto* ev = writer.reserve<bench_event>(payload);
+                if (ev == nullptr)
+                {
+                    return false;
+                }
+                ev->value = i;
+                writer.commit();
+                payload = payload_size(rng);
+                return true;
+            });
+        });
+}
+
+// Like a CUDA application: a handful of kernels launched over and over, every kernel once
+// defined with its name, see contrib/dummy_gpu_events.cpp
+bool gpu_mix(uint64_t events)
+{
+    return run<lo2s::gpu::RingbufWriter>(
+        "gpu kernels",
+        1,
+        []() { return std::make_unique<lo2s::gpu::RingbufWriter>(lo2s::Process::me()); },
+        [events](lo2s::gpu::RingbufWriter& writer, std::size_t, ProducerResult& result) {
+            static const char* names[] = {
+                "void gemm_kernel<float, 128, 128>(float const*, float const*, float*, int)",
+                "void reduce_kernel<double>(double const*, double*, unsigned long)",
+                "elementwise_add", "softmax_forward", "memset_kernel"
+            };
+
+            produce(events, result, [&writer](uint64_t i) {
+                const char* name = names[i % 5];
+                uint64_t const cctx = writer.kernel_def(name);
+                auto start = writer.timestamp();
+                return writer.kernel(start, start + 1000, cctx);
+            });
+        });
+}
+
+// Like an OpenMP application: all threads write enter/leave pairs through the single, mutex
+// protected writer of the process.
+bool ompt_mix(uint64_t events, std::size_t threads)
+{
+    return run<lo2s::ompt::RingbufWriter>(
+        "ompt " + std::to_string(threads) + " threads",
+        threads,
+        []() { return std::make_unique<lo2s::ompt::RingbufWriter>(lo2s::Process::me()); },
+        [events, threads](lo2s::ompt::RingbufWriter& writer, std::size_t thread,
+                          ProducerResult& result) {
+            static const lo2s::ompt::OMPType types[] = { lo2s::ompt::OMPType::PARALLEL,
+                                                         lo2s::ompt::OMPType::LOOP,
+                                                         lo2s::ompt::OMPType::SYNC };
+
+            produce(events / threads, result, [&writer, thread](uint64_t i) {
+                lo2s::ompt::OMPTCctx const cctx(types[(i / 2) % 3],
+                                                reinterpret_cast<const void*>(thread), 1);
+                struct timespec ts;
+                clock_gettime(CLOCK_MONOTONIC, &ts);
+                uint64_t const tp = (ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+
+                return i % 2 == 0 ? writer.ompt_enter(tp, cctx) : writer.ompt_leave(tp, cctx);
+            });
+        });
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    uint64_t events = 1000000;
+    std::size_t threads = 4;
+
+    if (argc > 1)
+    {
+        events = std::strtoull(argv[1], nullptr, 10);
+    }
+    if (argc > 2)
+    {
+        threads = std::max<std::size_t>(1, std::strtoull(argv[2], nullptr, 10));
+    }
+
+    socket_path = "/tmp/lo2s_ringbuf_bench_" + std::to_string(getpid()) + ".socket";
+    setenv("LO2S_SOCKET", socket_path.c_str(), 1);
+
+    std::cout << std::left << std::setw(28) << "scenario" << std::right << std::setw(12)
+              << "events" << std::setw(14) << "events/s" << std::setw(12) << "MiB/s"
+              << std::setw(10) << "p99 ns" << std::setw(12) << "retries" << "\n";
+
+    bool success = fixed_size(events);
+    success &= variable_size(events);
+    success &= gpu_mix(events);
+    success &= ompt_mix(events, threads);
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
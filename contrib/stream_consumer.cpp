@@ -0,0 +1,261 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Minimal consumer for the lo2s live event stream (lo2s --stream PATH).
+//
+// Listens on the unix domain socket PATH and accepts lo2s connections one after another. Prints a
+// summary of the received records and the most frequently sampled instruction addresses whenever
+// lo2s disconnects. Exits after COUNT connections, if given.
+
+#include <lo2s/stream/format.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+
+extern "C"
+{
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+}
+
+using namespace lo2s::stream;
+
+namespace
+{
+struct Source
+{
+    std::string name;
+    std::map<uint64_t, cctx_record> cctxs;
+};
+
+std::map<RecordType, uint64_t> record_counts;
+std::map<uint64_t, Source> sources;
+std::map<uint64_t, uint64_t> address_samples;
+
+// Size of the fixed part of each record type, 0 for unknown types
+std::size_t record_size(RecordType type)
+{
+    switch (type)
+    {
+    case RecordType::SOURCE:
+        return sizeof(source_record);
+    case RecordType::CCTX:
+        return sizeof(cctx_record);
+    case RecordType::CCTX_SAMPLE:
+        return sizeof(cctx_event_record);
+    default:
+        return sizeof(record_header);
+    }
+}
+
+bool handle_record(Source& source, const record_header* header)
+{
+    auto type = static_cast<RecordType>(header->type);
+    if (header->size < record_size(type))
+    {
+        std::cerr << "Received record of type " << header->type << " with invalid size "
+                  << header->size << std::endl;
+        return false;
+    }
+    record_counts[type]++;
+
+    switch (type)
+    {
+    case RecordType::SOURCE:
+    {
+        const auto* record = reinterpret_cast<const source_record*>(header);
+        source.name = std::string(record->name, strnlen(record->name, sizeof(record->name)));
+        break;
+    }
+    case RecordType::CCTX:
+    {
+        const auto* record = reinterpret_cast<const cctx_record*>(header);
+        source.cctxs.emplace(record->ref, *record);
+        break;
+    }
+    case RecordType::CCTX_SAMPLE:
+    {
+        const auto* record = reinterpret_cast<const cctx_event_record*>(header);
+        auto it = source.cctxs.find(record->ref);
+        if (it != source.cctxs.end())
+        {
+            address_samples[it->second.value]++;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    return true;
+}
+
+bool handle_batch(const std::vector<char>& buffer, std::size_t size)
+{
+    if (size < sizeof(batch_header))
+    {
+        std::cerr << "Received truncated batch" << std::endl;
+        return false;
+    }
+
+    const auto* batch = reinterpret_cast<const batch_header*>(buffer.data());
+    if (batch->version != STREAM_VERSION || batch->size != size)
+    {
+        std::cerr << "Received batch with unexpected version or size" << std::endl;
+        return false;
+    }
+
+    auto& source = sources[batch->source];
+
+    std::size_t offset = sizeof(batch_header);
+    for (uint64_t i = 0; i < batch->num_records; i++)
+    {
+        if (size - offset < sizeof(record_header))
+        {
+            std::cerr << "Received batch with truncated record" << std::endl;
+            return false;
+        }
+
+        const auto* header = reinterpret_cast<const record_header*>(buffer.data() + offset);
+        // A record that does not even cover its own header would never advance the offset
+        if (header->size < sizeof(record_header) || header->size > size - offset)
+        {
+            std::cerr << "Received batch with truncated record" << std::endl;
+            return false;
+        }
+        if (!handle_record(source, header))
+        {
+            return false;
+        }
+        offset += header->size;
+    }
+    return true;
+}
+
+void print_summary(uint64_t num_batches)
+{
+    std::cout << "batches: " << num_batches << "\n";
+    std::cout << "sources: " << sources.size() << "\n";
+    std::cout << "cctx definitions: " << record_counts[RecordType::CCTX] << "\n";
+    std::cout << "samples: " << record_counts[RecordType::CCTX_SAMPLE] << "\n";
+    std::cout << "enters: " << record_counts[RecordType::CCTX_ENTER] << "\n";
+    std::cout << "leaves: " << record_counts[RecordType::CCTX_LEAVE] << "\n";
+    std::cout << "metrics: " << record_counts[RecordType::METRIC] << "\n";
+    std::cout << "I/O operations: " << record_counts[RecordType::IO_BEGIN] << "\n";
+
+    std::vector<std::pair<uint64_t, uint64_t>> top(address_samples.begin(),
+                                                   address_samples.end());
+    std::sort(top.begin(), top.end(),
+              [](const auto& lhs, const auto& rhs) { return lhs.second > rhs.second; });
+    top.resize(std::min<std::size_t>(top.size(), 10));
+
+    for (const auto& entry : top)
+    {
+        std::cout << "0x" << std::hex << entry.first << std::dec << ": " << entry.second
+                  << " samples\n";
+    }
+    std::cout << std::flush;
+}
+
+// Receives the batches of one lo2s connection until it disconnects
+bool handle_connection(int fd)
+{
+    record_counts.clear();
+    sources.clear();
+    address_samples.clear();
+
+    std::vector<char> buffer(MAX_BATCH_SIZE);
+    uint64_t num_batches = 0;
+    ssize_t size = 0;
+    while ((size = recv(fd, buffer.data(), buffer.size(), 0)) != 0)
+    {
+        if (size == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            std::cerr << "Could not receive batch: " << strerror(errno) << std::endl;
+            return false;
+        }
+        if (!handle_batch(buffer, size))
+        {
+            return false;
+        }
+        num_batches++;
+    }
+
+    print_summary(num_batches);
+    return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc != 2 && argc != 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " PATH [COUNT]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // 0 accepts connections until killed
+    uint64_t max_connections = 0;
+    if (argc == 3)
+    {
+        max_connections = std::strtoull(argv[2], nullptr, 10);
+    }
+
+    struct sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, argv[1], sizeof(addr.sun_path) - 1);
+
+    int listen_fd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    unlink(argv[1]);
+    if (listen_fd == -1 ||
+        bind(listen_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == -1 ||
+        listen(listen_fd, 1) == -1)
+    {
+        std::cerr << "Could not listen on " << argv[1] << ": " << strerror(errno) << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int ret = EXIT_SUCCESS;
+    for (uint64_t num_connections = 0;
+         max_connections == 0 || num_connections < max_connections;)
+    {
+        int fd = accept(listen_fd, nullptr, nullptr);
+        if (fd == -1)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+            std::cerr << "Could not accept connection: " << strerror(errno) << std::endl;
+            ret = EXIT_FAILURE;
+            break;
+        }
+
+        // A broken connection does not keep the next lo2s run from connecting
+        if (!handle_connection(fd))
+        {
+            ret = EXIT_FAILURE;
+        }
+        close(fd);
+        num_connections++;
+    }
+
+    close(listen_fd);
+    unlink(argv[1]);
+
+    return ret;
+}
@@ -0,0 +1,47 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Test program for --dwarf-unwinding, built without frame pointers.
+//
+// Spends its time in lo2s_unwind_leaf(), which is only ever called through lo2s_unwind_middle()
+// and lo2s_unwind_outer(), so every sample of it has to unwind through the two of them.
+
+#include <cstdint>
+#include <cstdlib>
+
+extern "C"
+{
+// Not static and not inlined, so that the functions keep their own symbols and frames
+__attribute__((noinline)) uint64_t lo2s_unwind_leaf(uint64_t iterations)
+{
+    volatile uint64_t sum = 0;
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        sum = sum + i;
+    }
+    return sum;
+}
+
+__attribute__((noinline)) uint64_t lo2s_unwind_middle(uint64_t iterations)
+{
+    // Using the result keeps the call from being turned into a jump
+    return lo2s_unwind_leaf(iterations) + 1;
+}
+
+__attribute__((noinline)) uint64_t lo2s_unwind_outer(uint64_t iterations)
+{
+    return lo2s_unwind_middle(iterations) + 1;
+}
+}
+
+int main(int argc, char** argv)
+{
+    uint64_t iterations = 100000000;
+    if (argc > 1)
+    {
+        iterations = std::strtoull(argv[1], nullptr, 10);
+    }
+
+    return lo2s_unwind_outer(iterations) == 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
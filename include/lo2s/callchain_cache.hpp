@@ -0,0 +1,134 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <lo2s/calling_context.hpp>
+
+#include <algorithm>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace lo2s
+{
+/**
+ * Bounded LRU cache mapping a sampled callchain to the leaf node it was inserted as into a
+ * LocalCctxTree.
+ *
+ * Hot loops produce the very same callchain over and over again, a cache hit saves walking down
+ * the tree frame by frame. Entries are keyed by the node the callchain was inserted below and by
+ * the instruction pointers of the callchain. As nodes are never removed from the tree, the cached
+ * node pointers stay valid.
+ */
+class CallchainCache
+{
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 1024;
+
+    CallchainCache(std::size_t capacity = DEFAULT_CAPACITY) : capacity_(capacity)
+    {
+        map_.reserve(capacity_);
+    }
+
+    LocalCctxMap::value_type* find(const LocalCctxMap::value_type* parent, uint64_t num_ips,
+                                   const uint64_t ips[])
+    {
+        auto range = map_.equal_range(hash(parent, num_ips, ips));
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            const auto& entry = *it->second;
+            if (entry.parent == parent && entry.ips.size() == num_ips &&
+                std::equal(entry.ips.begin(), entry.ips.end(), ips))
+            {
+                // Move to the front, i.e. mark as most recently used
+                entries_.splice(entries_.begin(), entries_, it->second);
+                hits_++;
+                return entry.leaf;
+            }
+        }
+        misses_++;
+        return nullptr;
+    }
+
+    void insert(const LocalCctxMap::value_type* parent, uint64_t num_ips, const uint64_t ips[],
+                LocalCctxMap::value_type* leaf)
+    {
+        if (capacity_ == 0)
+        {
+            return;
+        }
+
+        if (entries_.size() == capacity_)
+        {
+            evict();
+        }
+
+        auto key = hash(parent, num_ips, ips);
+        entries_.push_front(Entry{ key, parent, std::vector<uint64_t>(ips, ips + num_ips), leaf });
+        map_.emplace(key, entries_.begin());
+    }
+
+    std::size_t hits() const
+    {
+        return hits_;
+    }
+
+    std::size_t misses() const
+    {
+        return misses_;
+    }
+
+private:
+    struct Entry
+    {
+        std::size_t key;
+        const LocalCctxMap::value_type* parent;
+        std::vector<uint64_t> ips;
+        LocalCctxMap::value_type* leaf;
+    };
+
+    static std::size_t hash(const LocalCctxMap::value_type* parent, uint64_t num_ips,
+                            const uint64_t ips[])
+    {
+        // FNV-1a over the words of the key, good enough for instruction pointers
+        constexpr uint64_t prime = 1099511628211ULL;
+        uint64_t result = 14695981039346656037ULL;
+
+        result = (result ^ reinterpret_cast<uintptr_t>(parent)) * prime;
+        result = (result ^ num_ips) * prime;
+        for (uint64_t i = 0; i < num_ips; i++)
+        {
+            result = (result ^ ips[i]) * prime;
+        }
+        return result;
+    }
+
+    void evict()
+    {
+        const auto& lru = entries_.back();
+
+        auto range = map_.equal_range(lru.key);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (&*it->second == &lru)
+            {
+                map_.erase(it);
+                break;
+            }
+        }
+        entries_.pop_back();
+    }
+
+    std::size_t capacity_;
+    std::list<Entry> entries_;
+    std::unordered_multimap<std::size_t, std::list<Entry>::iterator> map_;
+
+    std::size_t hits_ = 0;
+    std::size_t misses_ = 0;
+};
+} // namespace lo2s
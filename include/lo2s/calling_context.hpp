@@ -13,6 +13,7 @@
 #include <map>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #include <cstdint>
 
@@ -260,6 +261,24 @@ private:
     };
 };
 
+// Memory access samples (--memory-sampling) of a calling context to a single data object
+struct DataAccesses
+{
+    uint64_t samples = 0;
+    // Sum of the access latencies (PERF_SAMPLE_WEIGHT), 0 if not supported by the event
+    uint64_t weight = 0;
+    // Samples that were served from (local or remote) DRAM according to PERF_SAMPLE_DATA_SRC
+    uint64_t dram = 0;
+
+    DataAccesses& operator+=(const DataAccesses& other)
+    {
+        samples += other.samples;
+        weight += other.weight;
+        dram += other.dram;
+        return *this;
+    }
+};
+
 // Node type of the tree containing the CallingContext -> local cctx reference number mappings.
 struct LocalCctxNode
 {
@@ -269,6 +288,10 @@ struct LocalCctxNode
 
     otf2::definition::calling_context::reference_type ref;
     std::map<CallingContext, LocalCctxNode> children;
+    // Sum of the --sample-counter deltas of all samples of this node, empty if there are none
+    std::vector<uint64_t> sample_counters;
+    // Memory access samples of this node by the data object they accessed
+    std::map<std::string, DataAccesses> data_accesses;
 };
 
 // Node type of the global cctx tree, containing CallingContext -> otf2::cctx mappings.
@@ -280,6 +303,8 @@ struct GlobalCctxNode
 
     const otf2::definition::calling_context* cctx;
     std::map<CallingContext, GlobalCctxNode> children;
+    std::vector<uint64_t> sample_counters;
+    std::map<std::string, DataAccesses> data_accesses;
 };
 
 using LocalCctxMap = std::map<CallingContext, LocalCctxNode>;
@@ -10,6 +10,8 @@
 
 #include <chrono>
 
+#include <cstdint>
+
 namespace lo2s
 {
 
@@ -24,6 +26,8 @@ struct AcceleratorConfig
     bool nec = false;
     std::chrono::microseconds nec_read_interval;
     std::chrono::milliseconds nec_check_interval;
+    std::uint64_t cupti_buffer_size = 0;
+    std::uint64_t cupti_buffer_count = 0;
 };
 
 void to_json(nlohmann::json& j, const AcceleratorConfig& config);
@@ -8,6 +8,8 @@
 #include <nitro/options/parser.hpp>
 #include <nlohmann/json_fwd.hpp>
 
+#include <cstdint>
+
 namespace lo2s
 {
 enum class DwarfUsage
@@ -25,6 +27,8 @@ struct DwarfConfig
     void check();
 
     DwarfUsage usage = DwarfUsage::NONE;
+    // Number of concurrent debuginfod downloads with --dwarf full
+    std::uint64_t debuginfod_jobs = 4;
 };
 
 void to_json(nlohmann::json& j, const DwarfConfig& config);
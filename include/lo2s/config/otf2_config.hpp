@@ -8,8 +8,11 @@
 #include <nitro/options/parser.hpp>
 #include <nlohmann/json_fwd.hpp>
 
+#include <chrono>
 #include <string>
 
+#include <cstddef>
+
 namespace lo2s
 {
 struct Otf2Config
@@ -18,6 +21,23 @@ struct Otf2Config
     static void add_parser(nitro::options::parser& parser);
 
     std::string trace_path;
+
+    // limits in bytes and bytes per second, 0 means unlimited
+    std::size_t max_trace_size = 0;
+    std::size_t max_trace_rate = 0;
+
+    // start a new trace archive after this time or (estimated) size, 0 means never
+    std::chrono::seconds rotate_interval{ 0 };
+    std::size_t rotate_size = 0;
+
+    // interval of the periodic trace size reports, 0 means never
+    std::chrono::seconds report_size_interval{ 0 };
+
+    // write the self-overhead of every monitor thread as metrics
+    bool overhead_metrics = false;
+
+    // unix domain socket of a live event stream consumer, empty if disabled
+    std::string stream_path;
 };
 
 void to_json(nlohmann::json& j, const Otf2Config& config);
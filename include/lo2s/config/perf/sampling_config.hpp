@@ -8,7 +8,9 @@
 #include <nitro/options/parser.hpp>
 #include <nlohmann/json_fwd.hpp>
 
+#include <chrono>
 #include <string>
+#include <vector>
 
 #include <cstdint>
 
@@ -26,12 +28,27 @@ struct SamplingConfig
     bool process_recording = false;
 
     std::uint64_t period = 0;
+    // target number of samples per second and sampled scope, 0 disables adaptive sampling
+    std::uint64_t adaptive_rate = 0;
     std::string event;
+    // counters read with every sample, their deltas are attributed to the sampled cctx
+    std::vector<std::string> counters;
 
     bool exclude_kernel = false;
     bool enable_callgraph = false;
+    // Unwind the user space call stack with DWARF CFI instead of frame pointers (--dwarf-unwinding)
+    bool dwarf_unwinding = false;
+    // Size of the user space stack snapshot taken with every sample for DWARF unwinding
+    std::uint32_t unwind_stack_size = 0;
+    // Record the data address, source and latency of every sample (--memory-sampling)
+    bool memory_sampling = false;
     bool disassemble = false;
     bool use_pebs = false;
+
+    // Record the intervals in which threads block, with the callchain they blocked in (--off-cpu)
+    bool off_cpu = false;
+    // Only record blocked intervals that took at least this long (--off-cpu-threshold)
+    std::chrono::nanoseconds off_cpu_threshold = std::chrono::nanoseconds(0);
 };
 
 void to_json(nlohmann::json& j, const SamplingConfig& config);
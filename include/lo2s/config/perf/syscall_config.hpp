@@ -21,9 +21,20 @@ struct SyscallConfig
     static void add_parser(nitro::options::parser& parser);
     SyscallConfig(nitro::options::arguments& arguments);
 
+    // Syscalls are filtered or aggregated in the kernel by BPF instead of recorded with perf
+    bool bpf() const
+    {
+        return threshold.count() != 0 || histograms;
+    }
+
     std::chrono::nanoseconds read_interval = std::chrono::nanoseconds(0);
     bool enabled = false;
     std::vector<int64_t> syscalls;
+    // Only record syscalls that took at least this long (--syscall-threshold)
+    std::chrono::nanoseconds threshold = std::chrono::nanoseconds(0);
+    // Write per-thread syscall statistics as metrics instead of events (--syscall-histograms)
+    bool histograms = false;
+    std::chrono::milliseconds histogram_interval = std::chrono::milliseconds(1000);
 };
 
 void to_json(nlohmann::json& j, const SyscallConfig& config);
@@ -53,6 +53,11 @@ struct Config
 
     int cgroup_fd = -1;
     std::size_t mmap_pages = 16;
+    bool numa_placement = true;
+    // Write group and userspace counter metrics as differences to the previous event, suppressing
+    // events without changes (--metric-deltas)
+    bool metric_deltas = false;
+    double metric_delta_threshold = 0;
     std::optional<clockid_t> clockid = std::nullopt;
 };
 
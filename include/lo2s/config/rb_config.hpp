@@ -25,6 +25,7 @@ struct RingbufConfig
     std::string socket_path;
     std::string injectionlib_path;
     uint64_t size = 0;
+    bool huge_pages = false;
     std::chrono::nanoseconds read_interval = std::chrono::nanoseconds(100);
 };
 
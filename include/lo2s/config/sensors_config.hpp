@@ -9,6 +9,8 @@
 #include <nlohmann/json_fwd.hpp>
 
 #include <chrono>
+#include <string>
+#include <vector>
 
 namespace lo2s
 {
@@ -20,6 +22,16 @@ struct SensorsConfig
     void check();
     bool enabled = false;
     std::chrono::milliseconds read_interval = std::chrono::milliseconds(0);
+
+    struct Selection
+    {
+        // matched against the sensor name "chip/feature (label)"
+        std::string pattern;
+        std::chrono::milliseconds read_interval;
+    };
+
+    // Sensors to record, all sensors are recorded if this is empty
+    std::vector<Selection> selection;
 };
 
 void to_json(nlohmann::json& j, const SensorsConfig& config);
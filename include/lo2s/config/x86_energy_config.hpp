@@ -8,6 +8,8 @@
 #include <nitro/options/parser.hpp>
 #include <nlohmann/json_fwd.hpp>
 
+#include <chrono>
+
 namespace lo2s
 {
 struct X86EnergyConfig
@@ -17,6 +19,11 @@ struct X86EnergyConfig
     void check() const;
 
     bool enabled = false;
+    // read all x86_energy counters from a single thread instead of one thread per counter
+    bool single_thread = false;
+    // CPU the single x86_energy thread is pinned to, -1 if it is not pinned
+    int cpu = -1;
+    std::chrono::milliseconds read_interval = std::chrono::milliseconds(0);
 };
 
 void to_json(nlohmann::json& j, const X86EnergyConfig& config);
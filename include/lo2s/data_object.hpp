@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <lo2s/address.hpp>
+#include <lo2s/dwfl_session.hpp>
+#include <lo2s/memory_map.hpp>
+#include <lo2s/types/process.hpp>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include <cstdint>
+
+extern "C"
+{
+#include <elfutils/libdwfl.h>
+}
+
+namespace lo2s
+{
+// A (data) mapping of a process, as reported by the PERF_RECORD_MMAP events of --memory-sampling
+class DataMapping
+{
+public:
+    DataMapping(std::string name) : name_(std::move(name))
+    {
+    }
+
+    std::string name() const
+    {
+        return name_;
+    }
+
+private:
+    std::string name_;
+};
+
+/**
+ * Resolves the data addresses of memory access samples (--memory-sampling) to the data objects
+ * they lie in.
+ *
+ * Addresses in file backed mappings are resolved to the global variable (STT_OBJECT symbol) they
+ * belong to, if the binary has a symbol for it, or the file otherwise. Addresses in the heap, the
+ * stack or anonymous mappings are resolved to the region they lie in, i.e. "[heap]", "[stack]" or
+ * "[anon]". Individual heap allocations are not tracked.
+ *
+ * The mappings and symbol tables of every process are shared by all the sample writers, each
+ * process behind its own lock.
+ */
+class DataObjectResolver
+{
+public:
+    static DataObjectResolver& instance()
+    {
+        static DataObjectResolver r;
+        return r;
+    }
+
+    DataObjectResolver(const DataObjectResolver&) = delete;
+    DataObjectResolver& operator=(const DataObjectResolver&) = delete;
+    DataObjectResolver(DataObjectResolver&&) = delete;
+    DataObjectResolver& operator=(DataObjectResolver&&) = delete;
+
+    ~DataObjectResolver() = default;
+
+    void add_mapping(Process process, uint64_t start, uint64_t end, uint64_t pgoff,
+                     const std::string& filename);
+
+    std::string lookup(Process process, uint64_t addr);
+
+private:
+    DataObjectResolver() = default;
+
+    struct ProcessState
+    {
+        ProcessState() : session("data objects")
+        {
+        }
+
+        // Protects everything below
+        std::mutex mutex;
+        MemoryMap<DataMapping> mappings;
+        // Load address of every binary, i.e. the start of its mapping at file offset 0
+        std::map<std::string, uint64_t> bases;
+        // Symbol tables of the binaries, only used for accesses to file backed mappings
+        DwflSession session;
+    };
+
+    ProcessState& process_state(Process process);
+
+    static void add_mapping(ProcessState& state, uint64_t start, uint64_t end, uint64_t pgoff,
+                            const std::string& filename);
+    static Dwfl_Module* module_for(ProcessState& state, const std::string& filename);
+
+    std::mutex mutex_;
+    std::map<Process, ProcessState> processes_;
+};
+} // namespace lo2s
@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cstddef>
+
+namespace lo2s
+{
+/**
+ * Downloads the debug information of binaries from the debuginfod servers in the background, with
+ * at most --debuginfod-jobs downloads at a time.
+ *
+ * The DwarfFunctionResolver of a prefetched binary waits for its download instead of starting one
+ * of its own, while the binaries that are already available can be resolved in the meantime.
+ * The outcome is remembered per build-id, so debug information that the servers do not have is
+ * only requested once. Downloads that failed for other reasons are requested again by the next
+ * prefetch, in the meantime the resolvers look the debug information up on their own.
+ *
+ * Does nothing without debuginfod support or without --dwarf full.
+ */
+class DebuginfoPrefetcher
+{
+public:
+    enum class State
+    {
+        // Not prefetched, e.g. because it is available locally or the download failed
+        UNKNOWN,
+        PENDING,
+        FOUND,
+        MISSING
+    };
+
+    struct Debuginfo
+    {
+        State state = State::UNKNOWN;
+        // Path of the downloaded debug information, if FOUND
+        std::string path;
+    };
+
+    static DebuginfoPrefetcher& instance()
+    {
+        static DebuginfoPrefetcher p;
+        return p;
+    }
+
+    DebuginfoPrefetcher(const DebuginfoPrefetcher&) = delete;
+    DebuginfoPrefetcher& operator=(const DebuginfoPrefetcher&) = delete;
+    DebuginfoPrefetcher(DebuginfoPrefetcher&&) = delete;
+    DebuginfoPrefetcher& operator=(DebuginfoPrefetcher&&) = delete;
+
+    ~DebuginfoPrefetcher();
+
+    // Starts downloading the debug information of the binaries, in the given order
+    void prefetch(const std::vector<std::string>& binaries);
+
+    // Returns the outcome of the prefetch of the build-id, waiting for it if it is still pending
+    Debuginfo wait_for(const std::string& build_id);
+
+    static std::string build_id_string(const unsigned char* bits, std::size_t len);
+
+private:
+    DebuginfoPrefetcher() = default;
+
+    struct Request
+    {
+        std::string binary;
+        std::vector<unsigned char> build_id;
+        std::string key;
+    };
+
+    void work();
+
+    std::mutex mutex_;
+    // Notified whenever new requests are queued
+    std::condition_variable requested_;
+    // Notified whenever a download finishes
+    std::condition_variable finished_;
+
+    std::deque<Request> requests_;
+    // By build_id_string()
+    std::map<std::string, Debuginfo> debuginfos_;
+
+    // Started on demand, up to --debuginfod-jobs, and kept until lo2s exits
+    std::vector<std::thread> workers_;
+    bool stop_ = false;
+};
+} // namespace lo2s
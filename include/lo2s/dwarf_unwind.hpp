@@ -0,0 +1,139 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <lo2s/dwfl_session.hpp>
+#include <lo2s/types/process.hpp>
+#include <lo2s/types/thread.hpp>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+extern "C"
+{
+#include <elfutils/libdwfl.h>
+}
+
+namespace lo2s
+{
+/**
+ * Unwinds the user space call stacks of samples with the DWARF call frame information (CFI) of
+ * the sampled binaries, for --dwarf-unwinding.
+ *
+ * Binaries built without frame pointers produce broken callchains with PERF_SAMPLE_CALLCHAIN.
+ * Instead, the samples contain the user space registers (PERF_SAMPLE_REGS_USER) and a snapshot of
+ * the top of the user space stack (PERF_SAMPLE_STACK_USER), which libdwfl unwinds.
+ *
+ * There is one libdwfl session per process, shared by all the sample writers, so that libdwfl
+ * caches the CFI of every module across all the samples of the process, no matter on which CPU
+ * they were recorded. Modules are only reported to the session once an unwound frame lies in
+ * their mapping.
+ *
+ * A libdwfl session must only be used by one thread at a time, so the samples of a process are
+ * unwound one after another, while the samples of different processes are unwound in parallel.
+ */
+class DwarfUnwinder
+{
+public:
+    // Unwinding stops after this many frames
+    static constexpr std::size_t MAX_FRAMES = 128;
+
+    // Registers to record with PERF_SAMPLE_REGS_USER
+    static uint64_t sample_regs_user();
+
+    static std::size_t num_sample_regs()
+    {
+        return __builtin_popcountll(sample_regs_user());
+    }
+
+    // Whether DWARF unwinding is implemented for the architecture lo2s was built for
+    static bool supported();
+
+    static DwarfUnwinder& instance()
+    {
+        static DwarfUnwinder u;
+        return u;
+    }
+
+    DwarfUnwinder(const DwarfUnwinder&) = delete;
+    DwarfUnwinder& operator=(const DwarfUnwinder&) = delete;
+    DwarfUnwinder(DwarfUnwinder&&) = delete;
+    DwarfUnwinder& operator=(DwarfUnwinder&&) = delete;
+
+    ~DwarfUnwinder() = default;
+
+    void add_mapping(Process process, uint64_t start, uint64_t end, uint64_t pgoff,
+                     const std::string& filename);
+
+    /**
+     * Unwind the user space stack of a sample, appending the instruction pointers, leaf first, to
+     * ips.
+     *
+     * regs are the registers as recorded with sample_regs_user(), stack is the snapshot of the
+     * stack, starting at the stack pointer.
+     */
+    void unwind(Process process, Thread thread, const uint64_t regs[], const char* stack,
+                uint64_t stack_size, std::vector<uint64_t>& ips);
+
+private:
+    DwarfUnwinder() = default;
+
+    struct Mapping
+    {
+        uint64_t end;
+        uint64_t pgoff;
+        std::string filename;
+    };
+
+    // The sample that is currently unwound, for the libdwfl callbacks
+    struct Current
+    {
+        Thread thread;
+        const uint64_t* regs = nullptr;
+        const char* stack = nullptr;
+        uint64_t stack_size = 0;
+        std::vector<uint64_t>* ips = nullptr;
+    };
+
+    struct ProcessState
+    {
+        explicit ProcessState(Process process) : process(process), session("unwinding")
+        {
+        }
+
+        Process process;
+
+        // Protects everything below
+        std::mutex mutex;
+        DwflSession session;
+        bool attached = false;
+        // mappings by their start address
+        std::map<uint64_t, Mapping> mappings;
+        Current current;
+    };
+
+    ProcessState& process_state(Process process);
+
+    static void add_mapping(ProcessState& state, uint64_t start, uint64_t end, uint64_t pgoff,
+                            const std::string& filename);
+    static bool prepare(ProcessState& state, uint64_t ip);
+    static void report_module(ProcessState& state, uint64_t addr);
+
+    static pid_t next_thread(Dwfl* dwfl, void* arg, void** thread_argp);
+    static bool memory_read(Dwfl* dwfl, Dwarf_Addr addr, Dwarf_Word* result, void* arg);
+    static bool set_initial_registers(Dwfl_Thread* thread, void* arg);
+    static int frame_callback(Dwfl_Frame* frame, void* arg);
+
+    static const Dwfl_Thread_Callbacks thread_callbacks_;
+
+    std::mutex mutex_;
+    std::map<Process, ProcessState> processes_;
+};
+} // namespace lo2s
@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <lo2s/types/process.hpp>
+#include <lo2s/util.hpp>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <cstdint>
+
+extern "C"
+{
+#include <elfutils/libdwfl.h>
+}
+
+namespace lo2s
+{
+/**
+ * A libdwfl session over the binaries mapped into a process, as used while recording by
+ * DwarfUnwinder and DataObjectResolver.
+ *
+ * Only what is in the binaries themselves is used, e.g. the CFI in .eh_frame or the symbol table.
+ * Separate debug information is never looked for, let alone downloaded from debuginfod.
+ *
+ * Binaries are only reported to the session once they are needed, see report().
+ *
+ * Not thread-safe.
+ */
+class DwflSession
+{
+public:
+    // purpose is what the session is used for, in messages
+    explicit DwflSession(std::string purpose) : purpose_(std::move(purpose))
+    {
+    }
+
+    // nullptr if the session could not be created
+    Dwfl* get();
+
+    /**
+     * Reports the binary filename, with its file offset 0 mapped at base, to the session and
+     * returns its module.
+     *
+     * Every binary is only tried once, also if libdwfl can not open it, e.g. [vdso] or deleted
+     * files, in which case nullptr is returned.
+     */
+    Dwfl_Module* report(const std::string& filename, uint64_t base);
+
+    bool tried(const std::string& filename, uint64_t base) const
+    {
+        return modules_.count(std::make_pair(filename, base)) != 0;
+    }
+
+    // Start over with an empty session, as modules can not be removed from a libdwfl session
+    void reset()
+    {
+        dwfl_.reset();
+        modules_.clear();
+    }
+
+private:
+    struct DwflDeleter
+    {
+        void operator()(Dwfl* dwfl)
+        {
+            dwfl_end(dwfl);
+        }
+    };
+
+    std::string purpose_;
+    std::unique_ptr<Dwfl, DwflDeleter> dwfl_;
+    std::map<std::pair<std::string, uint64_t>, Dwfl_Module*> modules_;
+};
+
+/**
+ * Calls add_mapping(start, end, pgoff, filename) for every mapping the process currently has.
+ *
+ * Processes that were already running when the recording started never report the mappings they
+ * already have, so this has to be done for every process before its first mmap event.
+ */
+template <class F>
+void add_existing_mappings(Process process, F add_mapping)
+{
+    for (const auto& mapping : read_maps(process))
+    {
+        add_mapping(mapping.first.range.start.value(), mapping.first.range.end.value(),
+                    mapping.first.pgoff.value(), mapping.second);
+    }
+}
+} // namespace lo2s
@@ -3,10 +3,12 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 #pragma once
 
+#include <functional>
 #include <stdexcept>
 #include <string>
 
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 
 #include <fmt/format.h>
@@ -97,8 +99,22 @@ public:
     }
 
 private:
+    friend struct std::hash<ExecutionScope>;
+
     ExecutionScopeType type;
     int64_t id;
 };
 
 } // namespace lo2s
+
+namespace std
+{
+template <>
+struct hash<lo2s::ExecutionScope>
+{
+    std::size_t operator()(const lo2s::ExecutionScope& scope) const
+    {
+        return std::hash<int64_t>()(scope.id) ^ static_cast<std::size_t>(scope.type);
+    }
+};
+} // namespace std
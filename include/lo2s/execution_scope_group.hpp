@@ -10,7 +10,16 @@
 #include <lo2s/types/process.hpp>
 #include <lo2s/types/thread.hpp>
 
-#include <map>
+#include <array>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <cstddef>
+#include <cstdint>
 
 namespace lo2s
 {
@@ -28,12 +37,8 @@ public:
 
     bool is_group(const ExecutionScope& scope) const
     {
-        const auto& it = groups_.find(scope);
-        if (it == groups_.end())
-        {
-            return false;
-        }
-        return it->second == scope;
+        auto parent = find(scope);
+        return parent.has_value() && *parent == scope;
     }
 
     bool is_process(const Thread& thread) const
@@ -43,51 +48,57 @@ public:
 
     ExecutionScope get_parent(const ExecutionScope& scope) const
     {
-        return groups_.at(scope);
+        auto parent = find(scope);
+        if (!parent.has_value())
+        {
+            throw std::out_of_range("Unknown execution scope");
+        }
+        return *parent;
     }
 
     Process get_process(Thread thread) const
     {
         // If we don't know the parent process by the time we get to know the child thread, we will
         // never know it, so just report pid 0
-        if (groups_.count(thread.as_scope()) == 0)
+        auto parent = find(thread.as_scope());
+        if (!parent.has_value())
         {
             return Process(0);
         }
-        return groups_.at(thread.as_scope()).as_process();
+        return parent->as_process();
     }
 
     void add_process(Process process)
     {
-        groups_.emplace(process.as_thread().as_scope(), process.as_scope());
+        insert(process.as_thread().as_scope(), process.as_scope());
     }
 
     void add_thread(Thread thread, Process process)
     {
-        groups_.emplace(thread.as_scope(), process.as_scope());
+        insert(thread.as_scope(), process.as_scope());
     }
 
     // If we only know the parent thread, try to find the parent process.
     void add_thread(Thread child, Thread parent)
     {
-        const auto& real_parent = groups_.find(parent.as_scope());
-        if (real_parent == groups_.end())
+        auto real_parent = find(parent.as_scope());
+        if (!real_parent.has_value())
         {
             // Per convention, the parent process always has to be a process, so convert here
             // accordinglt
             Log::debug() << "No parent process found for " << child << " using " << parent
                          << "as a parent instead";
-            groups_.emplace(child.as_scope(), parent.as_process().as_scope());
+            insert(child.as_scope(), parent.as_process().as_scope());
         }
         else
         {
-            groups_.emplace(child.as_scope(), real_parent->second);
+            insert(child.as_scope(), *real_parent);
         }
     }
 
     void add_cpu(Cpu cpu)
     {
-        groups_.emplace(cpu.as_scope(), cpu.as_scope());
+        insert(cpu.as_scope(), cpu.as_scope());
     }
 
     ExecutionScopeGroup(ExecutionScopeGroup&) = delete;
@@ -102,6 +113,48 @@ private:
 
     ~ExecutionScopeGroup() = default;
 
-    std::map<ExecutionScope, ExecutionScope> groups_;
+    // The scopes are spread over several independently locked stripes. Lookups are done from all
+    // the monitoring threads, while new scopes are only added on fork and clone, so each stripe
+    // is protected by a reader/writer lock.
+    struct Stripe
+    {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<ExecutionScope, ExecutionScope> groups;
+    };
+
+    static constexpr std::size_t NUM_STRIPES = 64;
+
+    Stripe& stripe(const ExecutionScope& scope)
+    {
+        return stripes_[std::hash<ExecutionScope>()(scope) % NUM_STRIPES];
+    }
+
+    const Stripe& stripe(const ExecutionScope& scope) const
+    {
+        return stripes_[std::hash<ExecutionScope>()(scope) % NUM_STRIPES];
+    }
+
+    std::optional<ExecutionScope> find(const ExecutionScope& scope) const
+    {
+        const auto& s = stripe(scope);
+        std::shared_lock<std::shared_mutex> const lock(s.mutex);
+
+        auto it = s.groups.find(scope);
+        if (it == s.groups.end())
+        {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    void insert(const ExecutionScope& scope, const ExecutionScope& parent)
+    {
+        auto& s = stripe(scope);
+        std::unique_lock<std::shared_mutex> const lock(s.mutex);
+
+        s.groups.emplace(scope, parent);
+    }
+
+    std::array<Stripe, NUM_STRIPES> stripes_;
 };
 } // namespace lo2s
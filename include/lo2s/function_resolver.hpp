@@ -9,6 +9,7 @@
 #include <lo2s/util.hpp>
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 
@@ -47,5 +48,29 @@ protected:
     std::string name_;
 };
 
+// Placeholder for the resolver of a binary that only loads it on the first lookup.
+//
+// Processes usually map far more binaries than they spend any time in, this way only the binaries
+// that actually appear in the samples have their symbols and DWARF information loaded.
+class LazyFunctionResolver : public FunctionResolver
+{
+public:
+    LazyFunctionResolver(std::string name) : FunctionResolver(std::move(name))
+    {
+    }
+
+    static std::shared_ptr<FunctionResolver> cache(const std::string& name)
+    {
+        return BinaryCache<LazyFunctionResolver>::instance()[name];
+    }
+
+    LineInfo lookup_line_info(Address addr) override;
+
+private:
+    std::once_flag loaded_;
+    std::shared_ptr<FunctionResolver> resolver_;
+};
+
+// Returns a (lazy) resolver for the binary, nullptr if it is not an executable mapping
 std::shared_ptr<FunctionResolver> function_resolver_for(const std::string& filename);
 } // namespace lo2s
@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+namespace lo2s::gpu
+{
+// CUPTI asks for a new buffer every time the current one is full and hands it back once its
+// records are processed. Instead of allocating and freeing a buffer every time, keep up to
+// max_free_ completed buffers around for reuse.
+class BufferPool
+{
+public:
+    BufferPool(std::size_t buffer_size, std::size_t max_free)
+    : buffer_size_(buffer_size), max_free_(max_free)
+    {
+    }
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+    BufferPool(BufferPool&&) = delete;
+    BufferPool& operator=(BufferPool&&) = delete;
+
+    void configure(std::size_t buffer_size, std::size_t max_free)
+    {
+        std::lock_guard<std::mutex> const lock(mutex_);
+        buffer_size_ = buffer_size;
+        max_free_ = max_free;
+    }
+
+    std::size_t buffer_size() const
+    {
+        return buffer_size_;
+    }
+
+    uint8_t* get()
+    {
+        {
+            std::lock_guard<std::mutex> const lock(mutex_);
+            if (!free_.empty())
+            {
+                auto* buffer = free_.back();
+                free_.pop_back();
+                return buffer;
+            }
+        }
+        return static_cast<uint8_t*>(malloc(buffer_size_));
+    }
+
+    void put(uint8_t* buffer)
+    {
+        {
+            std::lock_guard<std::mutex> const lock(mutex_);
+            if (free_.size() < max_free_)
+            {
+                free_.emplace_back(buffer);
+                return;
+            }
+        }
+        free(buffer);
+    }
+
+    ~BufferPool()
+    {
+        for (auto* buffer : free_)
+        {
+            free(buffer);
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    std::size_t buffer_size_;
+    std::size_t max_free_;
+    std::vector<uint8_t*> free_;
+};
+} // namespace lo2s::gpu
@@ -9,8 +9,10 @@
 #include <lo2s/rb/writer.hpp>
 #include <lo2s/types/process.hpp>
 
+#include <functional>
 #include <map>
 #include <string>
+#include <string_view>
 
 #include <cstdint>
 #include <cstring>
@@ -27,11 +29,16 @@ public:
 
     // Creates new local cctx_ref. Returns result from local map if it already
     // exists. Otherwise, generates a kernel_def event.
-    uint64_t kernel_def(std::string func)
+    //
+    // Looking up an already defined kernel compares the name contents, but neither copies nor
+    // allocates, so it is cheap enough to do for every kernel record. CUPTI does not give kernels
+    // a stable id, and the memory its name pointers point to may be reused for other kernels.
+    uint64_t kernel_def(std::string_view func)
     {
-        if (cctxs_.count(func))
+        auto it = cctxs_.find(func);
+        if (it != cctxs_.end())
         {
-            return cctxs_.at(func);
+            return it->second;
         }
 
         auto* ev = reserve<struct kernel_def>(func.size());
@@ -43,7 +50,7 @@ public:
 
         auto cctx = cctxs_.emplace(func, next_cctx_ref_);
 
-        memcpy(ev->function, func.c_str(), func.size());
+        memcpy(ev->function, func.data(), func.size());
 
         ev->header.type = (uint64_t)EventType::KERNEL_DEF;
         ev->kernel_id = cctx.first->second;
@@ -91,7 +98,8 @@ public:
     }
 
 private:
-    std::map<std::string, uint64_t> cctxs_;
+    // std::less<> for looking up kernels by std::string_view
+    std::map<std::string, uint64_t, std::less<>> cctxs_;
     uint64_t next_cctx_ref_ = 0;
 };
 
@@ -3,8 +3,10 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 #pragma once
 
+#include <lo2s/callchain_cache.hpp>
 #include <lo2s/calling_context.hpp>
 #include <lo2s/measurement_scope.hpp>
+#include <lo2s/stream/stream.hpp>
 #include <lo2s/trace/fwd.hpp>
 
 #include <otf2xx/chrono/time_point.hpp>
@@ -32,13 +34,12 @@ class LocalCctxTree
 public:
     LocalCctxTree(trace::Trace& trace, MeasurementScope scope);
 
-    void finalize()
-    {
-        ref_count_ = next_cctx_ref_;
-    }
+    void finalize();
 
-    void cctx_sample(otf2::chrono::time_point& tp, uint64_t num_ips, const uint64_t ips[]);
-    void cctx_sample(otf2::chrono::time_point tp, uint64_t ip);
+    // Both cctx_sample variants return the node the sample was written for
+    LocalCctxNode& cctx_sample(otf2::chrono::time_point& tp, uint64_t num_ips,
+                               const uint64_t ips[]);
+    LocalCctxNode& cctx_sample(otf2::chrono::time_point tp, uint64_t ip);
 
     // All cctx_enter variants return the level of the first new node on the call stack.
     // This allows for constructs such as:
@@ -102,6 +103,7 @@ public:
         while (level > 0 && cur_level() >= level)
         {
             writer_.write_calling_context_leave(tp, cur_.back()->second.ref);
+            stream_.cctx_leave(tp, cur_.back()->second.ref);
             cur_.pop_back();
         }
 
@@ -140,6 +142,7 @@ private:
             // We are on a definitely new part of the callstack.
             cur_.emplace_back(create_cctx_node(cctx, cur_.back()));
             writer_.write_calling_context_enter(tp, cur_.back()->second.ref, 2);
+            stream_.cctx_enter(tp, cur_.back()->second.ref);
         }
         else
         {
@@ -157,6 +160,7 @@ private:
                 cctx_leave(tp, level);
                 cur_.emplace_back(create_cctx_node(cctx, cur_.back()));
                 writer_.write_calling_context_enter(tp, cur_.back()->second.ref, 2);
+                stream_.cctx_enter(tp, cur_.back()->second.ref);
             }
         }
     }
@@ -171,6 +175,7 @@ private:
         if (ret.second)
         {
             next_cctx_ref_++;
+            stream_.cctx(ret.first->second.ref, node->second.ref, cctx);
         }
 
         return &(*ret.first);
@@ -180,7 +185,9 @@ private:
 
     trace::Trace& trace_;
     otf2::writer::local& writer_;
+    stream::Writer stream_;
     std::vector<LocalCctxMap::value_type*> cur_;
+    CallchainCache callchain_cache_;
     std::atomic<size_t> ref_count_ = 0;
     size_t next_cctx_ref_ = 0;
 };
@@ -22,6 +22,8 @@ enum class MeasurementScopeType
     NEC_METRIC,
     BIO,
     SYSCALL,
+    SYSCALL_METRIC,
+    OFF_CPU,
     GPU,
     TRACEPOINT,
     POSIX_IO,
@@ -72,6 +74,16 @@ struct MeasurementScope
         return { MeasurementScopeType::SYSCALL, s };
     }
 
+    static MeasurementScope syscall_metric(ExecutionScope s)
+    {
+        return { MeasurementScopeType::SYSCALL_METRIC, s };
+    }
+
+    static MeasurementScope off_cpu(ExecutionScope s)
+    {
+        return { MeasurementScopeType::OFF_CPU, s };
+    }
+
     static MeasurementScope gpu(ExecutionScope s)
     {
         return { MeasurementScopeType::GPU, s };
@@ -126,6 +138,10 @@ struct MeasurementScope
             return fmt::format("block layer I/O events for {}", scope.name());
         case MeasurementScopeType::SYSCALL:
             return fmt::format("syscall events for {}", scope.name());
+        case MeasurementScopeType::SYSCALL_METRIC:
+            return fmt::format("syscall metrics for {}", scope.name());
+        case MeasurementScopeType::OFF_CPU:
+            return fmt::format("off-CPU events for {}", scope.name());
         case lo2s::MeasurementScopeType::GPU:
             return fmt::format("gpu kernel events for {}", scope.name());
         case MeasurementScopeType::TRACEPOINT:
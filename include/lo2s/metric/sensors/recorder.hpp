@@ -38,13 +38,29 @@ protected:
     }
 
 private:
-    otf2::writer::local& otf2_writer_;
+    struct Sensor
+    {
+        const void* chip;
+        int subfeature;
+        // Open hwmon file of the sensor, -1 if it has to be read through libsensors
+        int fd;
+        // Factor between the raw hwmon value and the value reported by libsensors
+        double scale;
+    };
 
-    otf2::definition::metric_instance metric_instance_;
-    std::unique_ptr<otf2::event::metric> event_;
+    // All sensors read at the same interval share a timer and a metric event
+    struct Group
+    {
+        int timer_fd;
+        otf2::definition::metric_instance metric_instance;
+        std::unique_ptr<otf2::event::metric> event;
+        std::vector<Sensor> sensors;
+    };
 
-    std::vector<std::pair<const void*, int>> items_;
+    static double read_sensor(const Sensor& sensor);
+
+    otf2::writer::local& otf2_writer_;
 
-    int fd_;
+    std::vector<Group> groups_;
 };
 } // namespace lo2s::metric::sensors
@@ -4,8 +4,6 @@
 
 #pragma once
 
-#include <memory>
-#include <vector>
 #ifndef HAVE_X86_ENERGY
 #error "Trying to build x86 energy stuff without x86 energy support"
 #endif
@@ -15,6 +13,9 @@
 
 #include <x86_energy.hpp>
 
+#include <memory>
+#include <vector>
+
 namespace lo2s::metric::x86_energy
 {
 class Metrics
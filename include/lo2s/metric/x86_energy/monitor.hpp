@@ -20,15 +20,22 @@
 #include <x86_energy.hpp>
 
 #include <string>
+#include <vector>
 
 namespace lo2s::metric::x86_energy
 {
+// Periodically reads one or more x86_energy counters, each into its own metric location.
 class Monitor : public monitor::PollMonitor
 {
 public:
-    Monitor(::x86_energy::SourceCounter counter, Cpu cpu, trace::Trace& trace,
-            const otf2::definition::metric_class& metric_class,
-            const otf2::definition::system_tree_node& stn);
+    // The thread of the monitor is pinned to pin_cpu, unless it is Cpu::invalid()
+    Monitor(trace::Trace& trace, const std::string& name, Cpu pin_cpu);
+
+    ~Monitor() override;
+
+    void add_counter(::x86_energy::SourceCounter counter, Cpu cpu,
+                     const otf2::definition::metric_class& metric_class,
+                     const otf2::definition::system_tree_node& stn);
 
 protected:
     void monitor(int fd) override;
@@ -40,13 +47,19 @@ protected:
     }
 
 private:
-    ::x86_energy::SourceCounter counter_;
+    struct Counter
+    {
+        Counter(::x86_energy::SourceCounter counter, otf2::writer::local& writer,
+                const otf2::definition::metric_instance& metric_instance);
 
-    Cpu cpu_;
+        ::x86_energy::SourceCounter counter;
+        otf2::writer::local& writer;
+        otf2::event::metric metric_event;
+    };
 
-    otf2::writer::local& otf2_writer_;
+    Cpu pin_cpu_;
+    int timer_fd_;
 
-    otf2::definition::metric_instance metric_instance_;
-    otf2::event::metric metric_event_;
+    std::vector<Counter> counters_;
 };
 } // namespace lo2s::metric::x86_energy
@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <lo2s/monitor/threaded_monitor.hpp>
+#include <lo2s/trace/fwd.hpp>
+#include <lo2s/types/thread.hpp>
+
+extern "C"
+{
+#include <bpf/libbpf.h>
+}
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include <cstddef>
+
+namespace lo2s::monitor
+{
+/**
+ * Common part of the monitors that read the events of a BPF program from a BPF ring buffer.
+ *
+ * The derived monitors load and attach their BPF program and then pass its maps to
+ * open_ring_buffer():
+ * - rb, the ring buffer, whose events are passed to handle_event()
+ * - pids, the threads that the program records, see insert_thread()
+ * - lost, optional, an array with a single counter of the events that did not fit into rb
+ */
+class BpfMonitor : public ThreadedMonitor
+{
+public:
+    struct RingBufferDeleter
+    {
+        void operator()(struct ring_buffer* rb)
+        {
+            ring_buffer__free(rb);
+        }
+    };
+
+    // For the skeletons generated by bpftool, e.g. SkelDeleter<off_cpu_bpf, off_cpu_bpf__destroy>
+    template <class T, void (*Destroy)(T*)>
+    struct SkelDeleter
+    {
+        void operator()(T* skel)
+        {
+            Destroy(skel);
+        }
+    };
+
+    // Inserts new thread into list of threads that should be recorded.
+    // This information is communicated to the BPF program via the pids map.
+    void insert_thread(Thread thread);
+    // Removes thread from list of threads that should be recorded
+    void exit_thread(Thread thread);
+
+    void stop() override;
+
+protected:
+    // program is the name of the BPF program in messages, events the name of its events
+    BpfMonitor(trace::Trace& trace, const std::string& name, std::string program,
+               std::string events);
+
+    void open_ring_buffer(struct bpf_map* rb, struct bpf_map* pids, struct bpf_map* lost);
+
+    virtual void handle_event(void* data, size_t datasz) = 0;
+
+    // Called after every poll of the ring buffer, at least every POLL_TIMEOUT
+    virtual void monitor()
+    {
+    }
+
+    void run() override;
+
+    static constexpr int POLL_TIMEOUT = 100;
+
+private:
+    static int event_cb(void* ctx, void* data, size_t datasz);
+
+    std::string program_;
+    std::string events_;
+
+    std::unique_ptr<struct ring_buffer, RingBufferDeleter> rb_;
+    struct bpf_map* pids_ = nullptr;
+    struct bpf_map* lost_ = nullptr;
+
+    std::atomic<bool> stop_ = false;
+};
+} // namespace lo2s::monitor
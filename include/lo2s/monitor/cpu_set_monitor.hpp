@@ -6,9 +6,16 @@
 
 #include <lo2s/monitor/main_monitor.hpp>
 #include <lo2s/monitor/scope_monitor.hpp>
+#ifdef HAVE_BPF
+#include <lo2s/monitor/off_cpu_monitor.hpp>
+#include <lo2s/monitor/syscall_monitor.hpp>
+#endif
 #include <lo2s/types/cpu.hpp>
 
 #include <map>
+#include <memory>
+
+#include <csignal>
 
 namespace lo2s::monitor
 {
@@ -22,9 +29,16 @@ class CpuSetMonitor : public MainMonitor
 public:
     CpuSetMonitor();
 
-    void run();
+    // Returns true if the recording should be continued in a new trace (--rotate-*)
+    bool run();
 
 private:
+    bool wait_for_sigint_or_rotation(sigset_t& ss);
+
     std::map<Cpu, ScopeMonitor> monitors_;
+#ifdef HAVE_BPF
+    std::unique_ptr<SyscallMonitor> syscall_monitor_;
+    std::unique_ptr<OffCpuMonitor> off_cpu_monitor_;
+#endif
 };
 } // namespace lo2s::monitor
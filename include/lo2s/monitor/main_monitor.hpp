@@ -16,6 +16,7 @@
 #endif
 #include <lo2s/monitor/io_monitor.hpp>
 #include <lo2s/monitor/socket_monitor.hpp>
+#include <lo2s/monitor/trace_size_monitor.hpp>
 #include <lo2s/monitor/tracepoint_monitor.hpp>
 #include <lo2s/perf/bio/writer.hpp>
 #include <lo2s/resolvers.hpp>
@@ -46,6 +47,7 @@ protected:
 
     std::unique_ptr<SocketMonitor> socket_monitor_;
     std::unique_ptr<IoMonitor<perf::bio::Writer>> bio_monitor_;
+    std::unique_ptr<TraceSizeMonitor> trace_size_monitor_;
 #ifdef HAVE_X86_ADAPT
     std::unique_ptr<metric::x86_adapt::Metrics> x86_adapt_metrics_;
 #endif
@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <lo2s/local_cctx_tree.hpp>
+#include <lo2s/monitor/bpf_monitor.hpp>
+#include <lo2s/perf/time/converter.hpp>
+#include <lo2s/trace/fwd.hpp>
+#include <lo2s/types/thread.hpp>
+
+extern "C"
+{
+#include <bpf/libbpf.h>
+#include <off_cpu.skel.h>
+}
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include <cstddef>
+
+namespace lo2s::monitor
+{
+/**
+ * BPF based off-CPU recording for --off-cpu.
+ *
+ * Samples only ever show where threads spend CPU time, but not where they wait for locks, I/O or
+ * timers. On sched_switch, the BPF program captures the callchain of every thread that blocks and
+ * submits it together with the blocked interval once the thread is scheduled in again.
+ *
+ * The interval is written as enter/leave of the calling contexts of the callchain, below the
+ * process and thread, into one LocalCctxTree per thread. Like for samples, the addresses are
+ * resolved with the memory mappings of the process when the trace is finalized.
+ *
+ * In process mode, only the threads added with insert_thread() are recorded, in system mode all
+ * threads except the ones of lo2s itself.
+ */
+class OffCpuMonitor : public BpfMonitor
+{
+public:
+    OffCpuMonitor(trace::Trace& trace, bool filter_threads);
+
+    std::string group() const override
+    {
+        return "OffCpuMonitor";
+    }
+
+protected:
+    void handle_event(void* data, size_t datasz) override;
+    void finalize_thread() override;
+
+private:
+    static constexpr int CCTX_LEVEL_PROCESS = 1;
+
+    trace::Trace& trace_;
+    perf::time::Converter& time_converter_;
+
+    std::map<Thread, LocalCctxTree*> local_cctx_trees_;
+
+    std::unique_ptr<struct off_cpu_bpf, SkelDeleter<struct off_cpu_bpf, off_cpu_bpf__destroy>>
+        skel_;
+};
+} // namespace lo2s::monitor
@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <lo2s/overhead.hpp>
+#include <lo2s/trace/fwd.hpp>
+
+#include <otf2xx/event/metric.hpp>
+#include <otf2xx/writer/local.hpp>
+
+#include <chrono>
+#include <string>
+
+#include <cstdint>
+
+namespace lo2s::monitor
+{
+/**
+ * Writes the overhead of a single monitor thread as metrics into its own metric location.
+ *
+ * The monitor reports each of its wakeups and calls update() regularly, at least once per
+ * INTERVAL. Both have to happen on the monitor thread, as the Overhead counters and the CPU time
+ * are per thread.
+ */
+class OverheadRecorder
+{
+public:
+    static constexpr std::chrono::milliseconds INTERVAL{ 1000 };
+
+    OverheadRecorder(trace::Trace& trace, const std::string& name);
+
+    // A wakeup of the monitor thread, in which it spent `latency` on handling its events
+    void wakeup(std::chrono::steady_clock::duration latency)
+    {
+        wakeups_++;
+        latency_ += latency;
+    }
+
+    // Write the metrics for the last interval, if it is over
+    void update();
+
+    // Time in milliseconds until update() has to be called next, suitable for poll()
+    int timeout() const;
+
+private:
+    trace::Trace& trace_;
+    otf2::writer::local& writer_;
+    otf2::event::metric event_;
+
+    std::chrono::steady_clock::time_point last_update_;
+    std::chrono::nanoseconds last_cpu_time_{ 0 };
+    Overhead last_;
+
+    std::uint64_t wakeups_ = 0;
+    std::chrono::steady_clock::duration latency_{ 0 };
+};
+} // namespace lo2s::monitor
@@ -45,6 +45,9 @@ protected:
     }
 
 private:
+    // Sends the stream batches that are due and returns the timeout for the next poll
+    int poll_timeout();
+
     std::vector<pollfd> pfds_;
 };
 } // namespace lo2s::monitor
@@ -4,8 +4,9 @@
 
 #pragma once
 
-#include <lo2s/monitor/threaded_monitor.hpp>
+#include <lo2s/monitor/bpf_monitor.hpp>
 #include <lo2s/perf/time/converter.hpp>
+#include <lo2s/stream/stream.hpp>
 #include <lo2s/trace/fwd.hpp>
 
 extern "C"
@@ -24,53 +25,22 @@ extern "C"
 
 namespace lo2s::monitor
 {
-class PosixMonitor : public ThreadedMonitor
+class PosixMonitor : public BpfMonitor
 {
 public:
-    struct RingBufferDeleter
-    {
-        void operator()(struct ring_buffer* rb)
-        {
-            ring_buffer__free(rb);
-        }
-    };
-
-    struct SkelDeleter
-    {
-        void operator()(struct posix_io_bpf* skel)
-        {
-            posix_io_bpf__destroy(skel);
-        }
-    };
-
     PosixMonitor(trace::Trace& trace);
 
     void insert_thread(Thread thread);
-    void exit_thread(Thread thread);
-
-    void initialize_thread() override
-    {
-    }
-
-    // General assumption here: A thread will at all times only be in one read()/write() call.
-    void handle_event(void* data, size_t datasz);
-
-    void run() override;
-    void stop() override;
-
-    void finalize_thread() override
-    {
-    }
-
-    void monitor()
-    {
-    }
 
     std::string group() const override
     {
         return "PosixMonitor";
     }
 
+protected:
+    // General assumption here: A thread will at all times only be in one read()/write() call.
+    void handle_event(void* data, size_t datasz) override;
+
 private:
     struct ThreadFd
     {
@@ -104,16 +74,15 @@ private:
 
     trace::Trace& trace_;
     perf::time::Converter& time_converter_;
+    stream::Writer stream_;
 
     std::map<Thread, int> last_fd_;
     std::map<Thread, uint64_t> last_count_;
     std::map<Thread, uint64_t> last_buf_;
     std::map<ThreadFd, int> instance_;
 
-    std::unique_ptr<struct ring_buffer, RingBufferDeleter> rb_;
-    std::unique_ptr<struct posix_io_bpf, SkelDeleter> skel_;
-
-    bool stop_ = false;
+    std::unique_ptr<struct posix_io_bpf, SkelDeleter<struct posix_io_bpf, posix_io_bpf__destroy>>
+        skel_;
 };
 
 } // namespace lo2s::monitor
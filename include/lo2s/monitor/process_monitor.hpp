@@ -7,7 +7,9 @@
 #include <lo2s/monitor/main_monitor.hpp>
 #include <lo2s/types/process.hpp>
 #ifdef HAVE_BPF
+#include <lo2s/monitor/off_cpu_monitor.hpp>
 #include <lo2s/monitor/posix_monitor.hpp>
+#include <lo2s/monitor/syscall_monitor.hpp>
 #endif
 #include <lo2s/monitor/scope_monitor.hpp>
 
@@ -41,6 +43,8 @@ private:
     std::map<Thread, ScopeMonitor> threads_;
 #ifdef HAVE_BPF
     std::unique_ptr<PosixMonitor> posix_monitor_;
+    std::unique_ptr<SyscallMonitor> syscall_monitor_;
+    std::unique_ptr<OffCpuMonitor> off_cpu_monitor_;
 #endif
 };
 } // namespace lo2s::monitor
@@ -48,7 +48,10 @@ public:
     }
 
 private:
+    void update_numa_node();
+
     ExecutionScope scope_;
+    int numa_node_ = -1;
     std::unique_ptr<perf::syscall::Writer> syscall_writer_;
     std::unique_ptr<perf::sample::Writer> sample_writer_;
     std::unique_ptr<perf::counter::group::Writer> group_counter_writer_;
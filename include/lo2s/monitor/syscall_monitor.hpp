@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <lo2s/local_cctx_tree.hpp>
+#include <lo2s/monitor/bpf_monitor.hpp>
+#include <lo2s/perf/syscall/histogram_writer.hpp>
+#include <lo2s/perf/time/converter.hpp>
+#include <lo2s/trace/fwd.hpp>
+#include <lo2s/types/thread.hpp>
+
+extern "C"
+{
+#include <bpf/libbpf.h>
+#include <syscall.skel.h>
+}
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace lo2s::monitor
+{
+/**
+ * BPF based syscall recording for --syscall-threshold.
+ *
+ * The BPF program remembers the enter time of every syscall per thread and only submits the
+ * syscalls that took longer than the threshold to lo2s. They are written as enter/leave of the
+ * syscall calling context, like perf::syscall::Writer does, but into one LocalCctxTree per thread.
+ * Only at syscall exit it is known whether a syscall is slow, so per-cpu locations could not be
+ * written in order.
+ *
+ * With --syscall-histograms, the BPF program does not submit any syscalls, but accumulates
+ * count, time and a latency histogram per thread and syscall in a map, which is written as metrics
+ * every --syscall-histogram-interval.
+ *
+ * In process mode, only the threads added with insert_thread() are recorded, in system mode all
+ * threads except the ones of lo2s itself.
+ */
+class SyscallMonitor : public BpfMonitor
+{
+public:
+    SyscallMonitor(trace::Trace& trace, bool filter_threads);
+
+    std::string group() const override
+    {
+        return "SyscallMonitor";
+    }
+
+protected:
+    void handle_event(void* data, size_t datasz) override;
+    void monitor() override;
+    void finalize_thread() override;
+
+private:
+    static constexpr int CCTX_LEVEL_SYSCALL = 1;
+
+    void write_histograms();
+
+    trace::Trace& trace_;
+    perf::time::Converter& time_converter_;
+
+    std::map<Thread, LocalCctxTree*> local_cctx_trees_;
+    std::map<std::pair<Thread, int64_t>, std::unique_ptr<perf::syscall::HistogramWriter>>
+        histogram_writers_;
+    std::chrono::steady_clock::time_point last_histograms_;
+
+    std::unique_ptr<struct syscall_bpf, SkelDeleter<struct syscall_bpf, syscall_bpf__destroy>>
+        skel_;
+};
+} // namespace lo2s::monitor
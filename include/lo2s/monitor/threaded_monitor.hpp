@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include <lo2s/monitor/overhead_recorder.hpp>
 #include <lo2s/trace/fwd.hpp>
 
+#include <memory>
 #include <string>
 #include <thread>
 
@@ -54,5 +56,8 @@ protected:
     std::string name_;
 
     std::size_t num_wakeups_ = 0;
+
+    // only set with --overhead-metrics
+    std::unique_ptr<OverheadRecorder> overhead_;
 };
 } // namespace lo2s::monitor
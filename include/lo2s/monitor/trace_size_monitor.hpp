@@ -0,0 +1,38 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <lo2s/monitor/poll_monitor.hpp>
+#include <lo2s/trace/fwd.hpp>
+
+#include <string>
+
+namespace lo2s::monitor
+{
+// Periodically reports the size of the trace written so far, see --report-trace-size
+class TraceSizeMonitor : public PollMonitor
+{
+public:
+    TraceSizeMonitor(trace::Trace& trace);
+
+    TraceSizeMonitor(TraceSizeMonitor&) = delete;
+    TraceSizeMonitor(TraceSizeMonitor&&) = delete;
+    TraceSizeMonitor& operator=(TraceSizeMonitor&) = delete;
+    TraceSizeMonitor& operator=(TraceSizeMonitor&&) = delete;
+
+    ~TraceSizeMonitor() override;
+
+    std::string group() const override
+    {
+        return "lo2s::TraceSizeMonitor";
+    }
+
+protected:
+    void monitor(int fd) override;
+
+private:
+    int timer_fd_;
+};
+} // namespace lo2s::monitor
@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <lo2s/execution_scope.hpp>
+
+#include <array>
+#include <climits>
+#include <cstddef>
+
+#include <sched.h>
+
+namespace lo2s
+{
+/**
+ * NUMA node all CPUs the scope can run on belong to.
+ *
+ * For a cpu that is the node of the cpu, for a thread the node its affinity mask is restricted
+ * to. Returns -1 if the scope is not confined to a single node or the system is not NUMA.
+ */
+int numa_node_of_scope(ExecutionScope scope);
+
+/**
+ * Prefer the given NUMA node for all memory the calling thread allocates from now on, -1 resets
+ * the memory policy to the default (local) allocation.
+ *
+ * A preferred node instead of a strict binding is used, so that lo2s still gets its buffers if
+ * that node runs out of memory.
+ */
+void try_prefer_numa_node(int node);
+
+/**
+ * Prefer the given NUMA node for the pages of the mapping [addr, addr + len) that are not
+ * allocated yet. For shared memory the policy is kept by the memory object, so it also applies to
+ * the pages that other processes mapping it touch first. Does nothing for -1.
+ */
+void try_prefer_numa_node(void* addr, std::size_t len, int node);
+
+/**
+ * Temporarily moves the calling thread to the CPUs of a NUMA node and prefers that node for its
+ * memory allocations, both are restored on destruction.
+ *
+ * Use this around the creation of buffers that are owned by a different thread than the one
+ * creating them. The kernel allocates the pages of a perf buffer for a thread (rather than a cpu)
+ * on the node of the cpu that maps them, heap memory is placed according to the memory policy.
+ */
+class NumaPlacement
+{
+public:
+    NumaPlacement(int node);
+    ~NumaPlacement();
+
+    NumaPlacement(const NumaPlacement&) = delete;
+    NumaPlacement(NumaPlacement&&) = delete;
+    NumaPlacement& operator=(const NumaPlacement&) = delete;
+    NumaPlacement& operator=(NumaPlacement&&) = delete;
+
+    static constexpr std::size_t MAX_NODES = 1024;
+    using NodeMask = std::array<unsigned long, MAX_NODES / (sizeof(unsigned long) * CHAR_BIT)>;
+
+private:
+    bool active_ = false;
+    cpu_set_t saved_affinity_;
+    int saved_mode_ = 0;
+    NodeMask saved_nodes_ = {};
+};
+} // namespace lo2s
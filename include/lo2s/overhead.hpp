@@ -0,0 +1,47 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <algorithm>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace lo2s
+{
+/**
+ * Counters of the work done by the current thread, the basis of the self-overhead metrics of the
+ * lo2s monitor threads (--overhead-metrics).
+ *
+ * The counters are thread local and only ever touched by their own thread, so keeping them up
+ * to date is as cheap as incrementing a plain integer. Readers of event buffers report every
+ * drain with record_drain(), the trace budget reports all bytes the thread writes.
+ */
+struct Overhead
+{
+    std::uint64_t drains = 0;
+    std::uint64_t records = 0;
+    // highest fill level of a drained buffer in per mille, reset by whoever reports it
+    std::uint64_t max_fill = 0;
+    // estimated amount of trace data written
+    std::size_t bytes = 0;
+
+    void record_drain(std::uint64_t num_records, std::uint64_t used, std::uint64_t size)
+    {
+        drains++;
+        records += num_records;
+        if (size != 0)
+        {
+            max_fill = std::max(max_fill, used * 1000 / size);
+        }
+    }
+
+    static Overhead& thread()
+    {
+        static thread_local Overhead overhead;
+        return overhead;
+    }
+};
+} // namespace lo2s
@@ -8,6 +8,7 @@
 #include <lo2s/perf/io_reader.hpp>
 #include <lo2s/perf/time/converter.hpp>
 #include <lo2s/perf/tracepoint/event_attr.hpp>
+#include <lo2s/stream/stream.hpp>
 #include <lo2s/trace/fwd.hpp>
 
 #include <map>
@@ -81,6 +82,7 @@ private:
     std::map<BlockDevice, std::map<uint64_t, uint64_t>> sector_cache_;
     trace::Trace& trace_;
     time::Converter& time_converter_;
+    stream::Writer stream_;
 
     // Unavailable until get_tracepoints() is called
     std::optional<perf::tracepoint::TracepointEventAttr> bio_queue_;
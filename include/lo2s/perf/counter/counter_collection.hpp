@@ -10,6 +10,8 @@
 #include <stdexcept>
 #include <vector>
 
+#include <cstddef>
+
 namespace lo2s::perf::counter
 {
 
@@ -19,6 +21,9 @@ struct CounterCollection
 
     std::optional<EventAttr> leader = std::nullopt;
     std::vector<EventAttr> counters;
+    // Indices into counters at which a new group starts, if the counters do not fit into a single
+    // group with the leader. Such groups are counted in turn, see group::Reader
+    std::vector<std::size_t> group_starts;
 
     bool empty() const
     {
@@ -51,6 +56,10 @@ struct CounterCollection
     {
         if (lhs.leader == rhs.leader)
         {
+            if (lhs.counters == rhs.counters)
+            {
+                return lhs.group_starts < rhs.group_starts;
+            }
             return lhs.counters < rhs.counters;
         }
         return lhs.leader < rhs.leader;
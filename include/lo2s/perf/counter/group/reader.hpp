@@ -5,6 +5,7 @@
 #pragma once
 
 #include <lo2s/config.hpp>
+#include <lo2s/error.hpp>
 #include <lo2s/execution_scope.hpp>
 #include <lo2s/log.hpp>
 #include <lo2s/measurement_scope.hpp>
@@ -13,16 +14,22 @@
 #include <lo2s/perf/event_attr.hpp>
 #include <lo2s/perf/event_composer.hpp>
 #include <lo2s/perf/event_reader.hpp>
+#include <lo2s/util.hpp>
 
+#include <chrono>
+#include <memory>
 #include <optional>
 #include <stdexcept>
 #include <vector>
 
+#include <cerrno>
+#include <cstddef>
 #include <cstdint>
 
 extern "C"
 {
 #include <linux/perf_event.h>
+#include <unistd.h>
 }
 
 namespace lo2s::perf::counter::group
@@ -32,6 +39,11 @@ namespace lo2s::perf::counter::group
 // This group has a group leader event, which triggers a readout of the other
 // events every --metric-count occurences. The value is then written into a memory-mapped
 // ring buffer, which we read out routinely to get the counter values.
+//
+// If the counters do not fit into a single group (see CounterCollection::group_starts), every
+// group gets a (non-sampling) copy of the leader and only one group is enabled at a time. Every
+// 1/--metric-frequency seconds, the active group is read out and the next one is enabled. Counters
+// keep their values while their group is inactive, they are not extrapolated.
 template <class T>
 class Reader : public EventReader<T>
 {
@@ -50,6 +62,12 @@ public:
         Log::debug() << "counter::Reader: leader event: '" << counter_collection_.leader->name()
                      << "'";
 
+        if (!counter_collection_.group_starts.empty())
+        {
+            open_rotation_groups(scope, enable_on_exec);
+            return;
+        }
+
         if (enable_on_exec)
         {
             counter_collection_.leader->set_enable_on_exec();
@@ -74,6 +92,14 @@ public:
         EventReader<T>::init_mmap(counter_leader_.value().get_fd());
     }
 
+    ~Reader()
+    {
+        if (rotation_timer_fd_ != -1)
+        {
+            close(rotation_timer_fd_);
+        }
+    }
+
     struct RecordSampleType
     {
         struct perf_event_header header;
@@ -81,10 +107,133 @@ public:
         struct GroupReadFormat v;
     };
 
+    int fd()
+    {
+        if (rotation_timer_fd_ != -1)
+        {
+            return rotation_timer_fd_;
+        }
+        return EventReader<T>::fd();
+    }
+
+    void read()
+    {
+        if (rotation_timer_fd_ != -1)
+        {
+            rotate();
+            return;
+        }
+        EventReader<T>::read();
+    }
+
 protected:
+    struct RotationGroup
+    {
+        RotationGroup(std::size_t first, std::size_t size)
+        : first(first), size(size), buffer(size + 1),
+          read_buffer(std::make_unique<std::byte[]>(GroupReadFormat::total_size(size + 1)))
+        {
+        }
+
+        // Index of the first counter of the group in counter_collection_.counters
+        std::size_t first;
+        std::size_t size;
+
+        std::optional<EventGuard> leader;
+        std::vector<EventGuard> members;
+        // Values of the leader copy, followed by the members
+        GroupCounterBuffer buffer;
+        std::unique_ptr<std::byte[]> read_buffer;
+    };
+
+    void open_rotation_groups(ExecutionScope scope, bool enable_on_exec)
+    {
+        // The groups are read out on the timer, the leaders only count
+        EventAttr leader = counter_collection_.leader.value();
+        leader.sample_period(0);
+        leader.set_disabled();
+
+        auto& counters = counter_collection_.counters;
+        auto& starts = counter_collection_.group_starts;
+        rotation_groups_.reserve(starts.size() + 1);
+        for (std::size_t i = 0; i <= starts.size(); i++)
+        {
+            std::size_t const first = i == 0 ? 0 : starts[i - 1];
+            std::size_t const last = i == starts.size() ? counters.size() : starts[i];
+            auto& group = rotation_groups_.emplace_back(first, last - first);
+
+            if (i == 0 && enable_on_exec)
+            {
+                EventAttr first_leader = leader;
+                first_leader.set_enable_on_exec();
+                group.leader = first_leader.open(scope, config().perf.cgroup_fd);
+            }
+            else
+            {
+                group.leader = leader.open(scope, config().perf.cgroup_fd);
+            }
+
+            for (std::size_t counter = first; counter < last; counter++)
+            {
+                group.members.emplace_back(group.leader->open_child(counters[counter], scope));
+            }
+        }
+
+        if (!enable_on_exec)
+        {
+            // Groups taken over from the previous trace (see EventHandover) may still be enabled
+            for (std::size_t i = 1; i < rotation_groups_.size(); i++)
+            {
+                rotation_groups_[i].leader->disable();
+            }
+            rotation_groups_.front().leader->enable();
+        }
+
+        rotation_timer_fd_ = timerfd_from_ns(std::chrono::nanoseconds(std::chrono::seconds(1)) /
+                                             config().perf.group.frequency);
+    }
+
+    void rotate()
+    {
+        auto& group = rotation_groups_[active_group_];
+
+        // The values are absolute, so what is counted until the group is disabled below is
+        // contained in its next read
+        auto* data = reinterpret_cast<GroupReadFormat*>(group.read_buffer.get());
+        if (::read(group.leader->get_fd(), data, GroupReadFormat::total_size(group.size + 1)) ==
+            -1)
+        {
+            throw_errno();
+        }
+
+        // Only the first group is enabled on exec, do not start rotating before that
+        if (data->time_enabled != 0)
+        {
+            // Disabling the leader stops the whole group
+            group.leader->disable();
+            group.buffer.read(data);
+
+            static_cast<T*>(this)->handle_rotation(active_group_);
+
+            active_group_ = (active_group_ + 1) % rotation_groups_.size();
+            rotation_groups_[active_group_].leader->enable();
+        }
+
+        [[maybe_unused]] uint64_t expirations = 0;
+        if (::read(rotation_timer_fd_, &expirations, sizeof(expirations)) == -1 && errno != EAGAIN)
+        {
+            Log::error() << "Flushing timer fd failed";
+            throw_errno();
+        }
+    }
+
     std::optional<EventGuard> counter_leader_;
     std::vector<EventGuard> counters_;
     CounterCollection counter_collection_;
     GroupCounterBuffer counter_buffer_;
+
+    std::vector<RotationGroup> rotation_groups_;
+    std::size_t active_group_ = 0;
+    int rotation_timer_fd_ = -1;
 };
 } // namespace lo2s::perf::counter::group
@@ -9,6 +9,8 @@
 #include <lo2s/perf/counter/metric_writer.hpp>
 #include <lo2s/trace/fwd.hpp>
 
+#include <cstddef>
+
 namespace lo2s::perf::counter::group
 {
 class Writer : public Reader<Writer>, MetricWriter
@@ -18,5 +20,12 @@ public:
 
     using Reader<Writer>::handle;
     bool handle(const RecordSampleType* sample);
+    // Called after the group with the given index has been read out, if the counters are counted
+    // in several groups in turn
+    void handle_rotation(std::size_t active_group);
+
+    // Writes the counter values an event was left out for with --metric-deltas, call after the
+    // last read()
+    void end();
 };
 } // namespace lo2s::perf::counter::group
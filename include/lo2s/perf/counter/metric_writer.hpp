@@ -5,23 +5,75 @@
 #pragma once
 #include <lo2s/measurement_scope.hpp>
 #include <lo2s/perf/time/converter.hpp>
+#include <lo2s/stream/stream.hpp>
+#include <lo2s/trace/budget.hpp>
 #include <lo2s/trace/fwd.hpp>
 
+#include <otf2xx/definition/metric_class.hpp>
 #include <otf2xx/definition/metric_instance.hpp>
 #include <otf2xx/event/metric.hpp>
 #include <otf2xx/writer/local.hpp>
 
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
 namespace lo2s::perf::counter
 {
 class MetricWriter
 {
 public:
     MetricWriter(MeasurementScope scope, trace::Trace& trace);
+    // Metrics of another class, whose instance is scoped to the metric location itself
+    MetricWriter(MeasurementScope scope, trace::Trace& trace,
+                 const otf2::definition::metric_class& metric_class);
 
 protected:
+    /**
+     * Writes metric_event_, unless the trace budget requires it to be decimated or dropped.
+     * Returns whether the event was written.
+     */
+    bool write_metric_event();
+
+    /**
+     * Writes counter_values_, followed by time_values_ and point_values_, as metric_event_.
+     *
+     * With --metric-deltas, the differences to the values of the last written event are written
+     * instead, and the event is left out if no counter value changed by more than
+     * --metric-delta-threshold. The time values are not considered for that, as they change with
+     * every event. The point values are always written as they are.
+     */
+    void write_counter_event();
+
+    /**
+     * With --metric-deltas, writes the last event that write_counter_event() left out, so that
+     * the trace still contains the final counter values. Call after the last readout.
+     */
+    void write_last_counter_event();
+
     time::Converter time_converter_;
     otf2::writer::local& writer_;
     otf2::definition::metric_instance metric_instance_;
     otf2::event::metric metric_event_;
+
+    // Current values for write_counter_event()
+    std::vector<double> counter_values_;
+    std::vector<uint64_t> time_values_;
+    std::vector<double> point_values_;
+
+private:
+    void write_counter_deltas();
+
+    trace::Budget& budget_;
+    std::size_t num_events_ = 0;
+
+    // Values of the last written event, only with --metric-deltas
+    std::vector<double> last_counter_values_;
+    std::vector<uint64_t> last_time_values_;
+    // Whether the current values have not been written
+    bool left_out_ = false;
+
+    stream::Writer stream_;
 };
 } // namespace lo2s::perf::counter
@@ -20,5 +20,9 @@ public:
     Writer(ExecutionScope scope, trace::Trace& trace);
 
     bool handle(std::vector<UserspaceReadFormat>& data);
+
+    // Writes the counter values an event was left out for with --metric-deltas, call after the
+    // last read()
+    void end();
 };
 } // namespace lo2s::perf::counter::userspace
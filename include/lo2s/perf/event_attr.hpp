@@ -6,6 +6,7 @@
 
 #include <lo2s/error.hpp>
 #include <lo2s/execution_scope.hpp>
+#include <lo2s/perf/event_handover.hpp>
 #include <lo2s/types/cpu.hpp>
 #include <lo2s/types/process.hpp>
 #include <lo2s/types/thread.hpp>
@@ -218,6 +219,13 @@ public:
         return attr_.mmap;
     }
 
+    // Additionally generates mmap events for mappings without PROT_EXEC, such as data segments,
+    // the heap or anonymous mappings. These have PERF_RECORD_MISC_MMAP_DATA set in header.misc.
+    void set_mmap_data()
+    {
+        attr_.mmap_data = 1;
+    }
+
     // Enables generation of context switch events. Context switch events
     // are generated when the kernels switches the process running on a CPU.
     void set_context_switch()
@@ -262,6 +270,18 @@ public:
         attr_.sample_type |= format;
     }
 
+    // Registers recorded with PERF_SAMPLE_REGS_USER, as a mask of the perf register numbers
+    void set_sample_regs_user(uint64_t regs)
+    {
+        attr_.sample_regs_user = regs;
+    }
+
+    // Size of the stack snapshot recorded with PERF_SAMPLE_STACK_USER
+    void set_sample_stack_user(uint32_t bytes)
+    {
+        attr_.sample_stack_user = bytes;
+    }
+
     friend std::ostream& operator<<(std::ostream& stream, const EventAttr& event);
 
     void set_watermark(uint64_t bytes)
@@ -407,6 +427,7 @@ public:
 
     void set_output(const EventGuard& other_ev) const;
     void set_syscall_filter(const std::vector<int64_t>& filter) const;
+    void set_sample_period(uint64_t period) const;
 
     int get_fd() const
     {
@@ -434,7 +455,7 @@ public:
 
     ~EventGuard()
     {
-        if (fd_ != -1)
+        if (fd_ != -1 && !EventHandover::instance().park(fd_))
         {
             close(fd_);
         }
@@ -15,6 +15,7 @@
 #include <string>
 #include <vector>
 
+#include <cstddef>
 #include <cstdint>
 
 #include <unistd.h>
@@ -38,6 +39,8 @@ public:
 
     EventAttr create_time_event(uint64_t local_time);
     EventAttr create_sampling_event();
+    // Members of the sampling event group, in the order of their values in a sample
+    std::vector<EventAttr> create_sample_counters();
     perf::tracepoint::TracepointEventAttr create_tracepoint_event(const std::string& name);
     std::vector<perf::tracepoint::TracepointEventAttr> emplace_tracepoints();
 
@@ -54,6 +57,7 @@ private:
 
     void emplace_userspace_counters();
     void emplace_group_counters();
+    std::vector<std::size_t> partition_group_counters(counter::CounterCollection& collection);
 
     std::optional<EventAttr> sampling_event_;
     std::optional<counter::CounterCollection> group_counters_;
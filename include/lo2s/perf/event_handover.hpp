@@ -0,0 +1,109 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <lo2s/execution_scope.hpp>
+#include <lo2s/shared_memory.hpp>
+
+#include <map>
+#include <mutex>
+#include <optional>
+#include <tuple>
+
+#include <cstddef>
+#include <cstring>
+
+extern "C"
+{
+#include <linux/perf_event.h>
+}
+
+namespace lo2s::perf
+{
+/**
+ * Keeps the perf events open while the monitors are rebuilt for the next trace of a rotation
+ * (--rotate-interval, --rotate-size).
+ *
+ * Between begin() and end(), events that are closed and the mappings of their ring buffers are
+ * parked instead. Opening an event with the same attributes for the same scope and group leader
+ * takes over the parked one, together with the records in its ring buffer that were not read
+ * yet. So the next trace starts exactly where the previous one was drained, and the counters keep
+ * counting across the traces. end() closes what was not taken over.
+ *
+ * Only does anything with trace rotation, otherwise events are opened and closed as usual.
+ */
+class EventHandover
+{
+public:
+    static EventHandover& instance()
+    {
+        static EventHandover h;
+        return h;
+    }
+
+    EventHandover(const EventHandover&) = delete;
+    EventHandover& operator=(const EventHandover&) = delete;
+    EventHandover(EventHandover&&) = delete;
+    EventHandover& operator=(EventHandover&&) = delete;
+
+    ~EventHandover();
+
+    // Start parking the events that are closed
+    void begin();
+    // Close all the parked events that were not taken over
+    void end();
+
+    // While parking, readers must not disable their events when they are stopped
+    bool active() const
+    {
+        return active_;
+    }
+
+    // Returns the fd of a matching parked event, or -1 if there is none
+    int claim(const perf_event_attr& attr, ExecutionScope scope, int group_fd, int cgroup_fd);
+    void opened(int fd, const perf_event_attr& attr, ExecutionScope scope, int group_fd,
+                int cgroup_fd);
+
+    // Returns true if the event was parked, it must then not be closed
+    bool park(int fd);
+
+    std::optional<SharedMemory> claim_mapping(int fd, std::size_t size);
+    // Takes the mapping of the ring buffer of a parked event
+    void park_mapping(int fd, SharedMemory& mapping);
+
+private:
+    EventHandover();
+
+    struct Key
+    {
+        perf_event_attr attr;
+        ExecutionScope scope;
+        int group_fd;
+        int cgroup_fd;
+
+        friend bool operator<(const Key& lhs, const Key& rhs)
+        {
+            if (std::tie(lhs.scope, lhs.group_fd, lhs.cgroup_fd) !=
+                std::tie(rhs.scope, rhs.group_fd, rhs.cgroup_fd))
+            {
+                return std::tie(lhs.scope, lhs.group_fd, lhs.cgroup_fd) <
+                       std::tie(rhs.scope, rhs.group_fd, rhs.cgroup_fd);
+            }
+            return std::memcmp(&lhs.attr, &rhs.attr, sizeof(perf_event_attr)) < 0;
+        }
+    };
+
+    const bool enabled_;
+    bool active_ = false;
+
+    std::mutex mutex_;
+    // Every open event, by fd
+    std::map<int, Key> events_;
+    // Events with equal keys are taken over in the order in which they were parked, e.g. the
+    // leaders of rotating counter groups
+    std::multimap<Key, int> parked_;
+    std::map<int, SharedMemory> mappings_;
+};
+} // namespace lo2s::perf
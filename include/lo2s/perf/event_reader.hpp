@@ -7,12 +7,16 @@
 #include <lo2s/build_config.hpp>
 #include <lo2s/config.hpp>
 #include <lo2s/log.hpp>
+#include <lo2s/overhead.hpp>
+#include <lo2s/perf/event_handover.hpp>
 #include <lo2s/perf/types.hpp>
 #include <lo2s/shared_memory.hpp>
 #include <lo2s/util.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <system_error>
+#include <utility>
 
 #include <cassert>
 #include <cstddef>
@@ -132,6 +136,12 @@ public:
 
     ~EventReader()
     {
+        // The ring buffer of an event that is taken over by the next trace must stay mapped
+        if (shmem_.as<void>() != nullptr)
+        {
+            EventHandover::instance().park_mapping(fd_, shmem_);
+        }
+
         if (lost_samples > 0)
         {
             Log::warn() << "Lost a total of " << lost_samples << " samples in event_reader<"
@@ -146,9 +156,18 @@ protected:
 
         mmap_pages_ = config().perf.mmap_pages;
 
+        std::size_t const size = (mmap_pages_ + 1) * get_page_size();
+
+        auto parked = EventHandover::instance().claim_mapping(fd, size);
+        if (parked)
+        {
+            shmem_ = std::move(*parked);
+            return;
+        }
+
         try
         {
-            shmem_ = SharedMemory(fd, (mmap_pages_ + 1) * get_page_size());
+            shmem_ = SharedMemory(fd, size);
         }
         catch (const std::system_error& e)
         {
@@ -165,21 +184,25 @@ public:
 
     EventReader(EventReader<T>&& other) noexcept
     {
+        std::swap(this->fd_, other.fd_);
         std::swap(this->shmem_, other.shmem_);
     }
 
     EventReader& operator=(EventReader&& other) noexcept
     {
+        std::swap(this->fd_, other.fd_);
         std::swap(this->shmem_, other.shmem_);
         return *this;
     }
 
-    int fd_;
+    int fd_ = -1;
     SharedMemory shmem_;
     std::byte event_copy[PERF_SAMPLE_MAX_SIZE] __attribute__((aligned(8)));
 
     void read()
     {
+        auto read_start = std::chrono::steady_clock::now();
+        const uint64_t used = data_head() - data_tail();
         int64_t read_samples = 0;
         while (!empty())
         {
@@ -233,6 +256,7 @@ public:
             {
                 // Use CRTP here because the struct type depends on the perf attr
                 using ActualSampleType = typename CRTP::RecordSampleType;
+                total_samples++;
                 stop = crtp_this->handle((const ActualSampleType*)event_header_p);
                 break;
             }
@@ -248,7 +272,10 @@ public:
                 break;
             }
         }
+        static_cast<CRTP*>(this)->read_done();
         Log::trace() << "read " << read_samples << " samples.";
+        Overhead::thread().record_drain(read_samples, used, data_size());
+        drain_time += std::chrono::steady_clock::now() - read_start;
     }
 
     void pop()
@@ -342,6 +369,12 @@ public:
         return fd_;
     }
 
+    // Called at the end of every read(), for the work that does not have to be done while the
+    // ring buffer is being emptied
+    void read_done()
+    {
+    }
+
     bool handle(const RecordForkType* fork [[maybe_unused]])
     {
         // It seems you get fork events even if not enabled via attr.task = true;
@@ -361,6 +394,8 @@ protected:
     int64_t total_samples = 0;
     int64_t throttle_samples = 0;
     int64_t lost_samples = 0;
+    // time spent by lo2s in read()
+    std::chrono::steady_clock::duration drain_time{};
     size_t mmap_pages_ = 0;
 };
 
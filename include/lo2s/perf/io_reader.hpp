@@ -5,6 +5,7 @@
 #pragma once
 
 #include <lo2s/log.hpp>
+#include <lo2s/perf/event_handover.hpp>
 #include <lo2s/perf/event_reader.hpp>
 #include <lo2s/perf/tracepoint/event_attr.hpp>
 #include <lo2s/types/cpu.hpp>
@@ -93,7 +94,11 @@ public:
 
     void stop()
     {
-        event_.disable();
+        // Events taken over by the next trace keep recording
+        if (!EventHandover::instance().active())
+        {
+            event_.disable();
+        }
     }
 
     TracepointSampleType* top()
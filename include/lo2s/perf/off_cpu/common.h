@@ -0,0 +1,22 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+// Maximum number of frames recorded for the kernel and the user part of a blocking callchain
+#define OFF_CPU_MAX_FRAMES 64
+
+// An interval in which a thread was blocked, submitted when the thread is scheduled in again.
+// The callchains are leaf first, as captured when the thread was scheduled out.
+struct off_cpu_event
+{
+    int pid;
+    int tid;
+    unsigned long long start_time;
+    unsigned long long end_time;
+    int num_kernel_ips;
+    int num_user_ips;
+    unsigned long long kernel_ips[OFF_CPU_MAX_FRAMES];
+    unsigned long long user_ips[OFF_CPU_MAX_FRAMES];
+};
@@ -13,6 +13,7 @@
 
 #include <stdexcept>
 #include <system_error>
+#include <vector>
 
 #include <cstdint>
 
@@ -43,8 +44,12 @@ public:
         uint64_t ip;
         uint32_t pid, tid;
         uint64_t time;
+        /* With --memory-sampling, cpu and res are preceded by the data address (PERF_SAMPLE_ADDR)
+         * and everything after time is only found at runtime, see Writer::handle() */
         uint32_t cpu, res;
-        /* only relevant for record_callgraph_ / PERF_SAMPLE_CALLCHAIN */
+        /* only relevant for record_callgraph_ / PERF_SAMPLE_CALLCHAIN
+         * With --sample-counter, this is preceded by the group read of the sample counters
+         * (PERF_SAMPLE_READ), the offset of nr and ips is then only known at runtime. */
         uint64_t nr;
         uint64_t ips[1]; // ISO C++ forbits zero-size array
     };
@@ -105,6 +110,20 @@ private:
     : record_callgraph_(config().perf.sampling.enable_callgraph),
       event_(create_sampling_event(scope, enable_on_exec))
     {
+        for (auto& counter : EventComposer::instance().create_sample_counters())
+        {
+            try
+            {
+                sample_counters_.emplace_back(event_.open_child(counter, scope));
+            }
+            catch (std::system_error& e)
+            {
+                throw std::runtime_error(
+                    fmt::format("Could not open sample counter '{}' for {}: {}", counter.name(),
+                                scope.name(), e.what()));
+            }
+        }
+
         init_mmap(event_.get_fd());
         Log::debug() << "mmap initialized";
 
@@ -116,5 +135,7 @@ private:
 
     friend T;
     EventGuard event_;
+    // --sample-counter events, members of the group led by event_
+    std::vector<EventGuard> sample_counters_;
 };
 } // namespace lo2s::perf::sample
@@ -4,18 +4,28 @@
 
 #pragma once
 
+#include <lo2s/calling_context.hpp>
+#include <lo2s/data_object.hpp>
+#include <lo2s/dwarf_unwind.hpp>
 #include <lo2s/execution_scope.hpp>
 #include <lo2s/local_cctx_tree.hpp>
 #include <lo2s/perf/sample/reader.hpp>
 #include <lo2s/perf/time/converter.hpp>
 #include <lo2s/perf/types.hpp>
 #include <lo2s/resolvers.hpp>
+#include <lo2s/trace/budget.hpp>
 #include <lo2s/trace/fwd.hpp>
 #include <lo2s/types/process.hpp>
 
 #include <otf2xx/chrono/time_point.hpp>
 #include <otf2xx/event/metric.hpp>
 
+#include <chrono>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
 namespace lo2s::perf::sample
 {
 
@@ -39,30 +49,88 @@ public:
     bool handle(const Reader::RecordSwitchCpuWideType* context_switch);
     bool handle(const Reader::RecordSwitchType* context_switch);
 
+    void read_done();
+
     void emplace_resolvers(Resolvers& resolvers);
     void end();
 
 private:
     static constexpr int CCTX_LEVEL_PROCESS = 1;
 
+    // Adaptive sampling (--adaptive-sampling) re-evaluates the period once per interval
+    static constexpr std::chrono::seconds ADAPT_INTERVAL{ 1 };
+    // Share of time lo2s may spend reading samples before the period is increased
+    static constexpr double MAX_DRAIN_SHARE = 0.05;
+    // Maximum factor by which the period is changed in a single interval
+    static constexpr double MAX_ADAPT_FACTOR = 4.0;
+    // Changes of the period smaller than this are not applied
+    static constexpr double ADAPT_TOLERANCE = 0.1;
+    static constexpr std::uint64_t MIN_PERIOD = 1000;
+
     void update_calling_context(Process process, Thread thread, otf2::chrono::time_point tp,
                                 bool switch_out);
 
     otf2::chrono::time_point adjust_timepoints(otf2::chrono::time_point tp);
 
+    void adjust_sampling_period(otf2::chrono::time_point tp);
+    void adapt_sampling_period(otf2::chrono::time_point tp);
+
+    // Attributes the deltas of the --sample-counter values to node, nullptr if the sample was
+    // dropped
+    void update_sample_counters(const uint64_t* values, LocalCctxNode* node);
+
+    void handle_sample(const Reader::RecordSampleType* sample);
+    // Handles the samples in pending_samples_, in the order they were read. Has to be called
+    // before any other event is written, to keep the events in order.
+    void handle_pending_samples();
+
+    // Unwinds the user space stack of a sample into unwound_ips_, regs is nullptr if the sample
+    // has no user space registers
+    void unwind(const Reader::RecordSampleType* sample, const uint64_t* regs, const char* stack,
+                uint64_t stack_size);
+
+    // Attributes a --memory-sampling sample to the data object at addr
+    void update_data_accesses(Process process, uint64_t addr, uint64_t weight, uint64_t data_src,
+                              LocalCctxNode& node);
+
     ExecutionScope scope_;
 
     trace::Trace& trace_;
     LocalCctxTree& local_cctx_tree_;
 
     otf2::event::metric cpuid_metric_event_;
+    otf2::event::metric sampling_period_event_;
 
     RawMemoryMapCache cached_mmap_events_;
 
     const time::Converter time_converter_;
 
+    // sampling period as chosen by adaptive sampling, before the trace budget is applied
+    std::uint64_t period_;
+    // sampling period currently set for the sampling event
+    std::uint64_t current_period_;
+    bool period_fixed_ = false;
+
+    otf2::chrono::time_point adapt_window_start_;
+    int64_t adapt_total_samples_ = 0;
+    int64_t adapt_throttle_samples_ = 0;
+    int64_t adapt_lost_samples_ = 0;
+    std::chrono::steady_clock::duration adapt_drain_time_{};
+
     bool first_event_ = true;
     otf2::chrono::time_point first_time_point_;
     otf2::chrono::time_point last_time_point_;
+
+    // --sample-counter values of the previous sample
+    std::vector<uint64_t> last_sample_counters_;
+
+    // Only with --dwarf-unwinding
+    DwarfUnwinder* unwinder_ = nullptr;
+    std::vector<uint64_t> unwound_ips_;
+    // Copies of the sample records that are not handled yet, see handle()
+    std::vector<std::byte> pending_samples_;
+
+    // Only with --memory-sampling
+    DataObjectResolver* data_objects_ = nullptr;
 };
 } // namespace lo2s::perf::sample
@@ -0,0 +1,35 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+// Syscalls are filtered by number through an array map with one entry per syscall number
+#define MAX_SYSCALL_NR 1024
+
+// A syscall that took longer than the threshold, submitted on syscall exit
+struct syscall_event
+{
+    int pid;
+    long long syscall_nr;
+    unsigned long long enter_time;
+    unsigned long long exit_time;
+};
+
+// Number of buckets of the latency histograms, bucket i counts the syscalls that took
+// [2^i, 2^(i+1)) ns, the last bucket also the ones that took longer
+#define SYSCALL_HISTOGRAM_BUCKETS 32
+
+struct syscall_stats_key
+{
+    int pid;
+    int syscall_nr;
+};
+
+// Accumulated statistics of a syscall in a thread, only ever increasing
+struct syscall_stats
+{
+    unsigned long long count;
+    unsigned long long time;
+    unsigned long long histogram[SYSCALL_HISTOGRAM_BUCKETS];
+};
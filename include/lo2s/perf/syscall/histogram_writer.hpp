@@ -0,0 +1,38 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <lo2s/perf/counter/metric_writer.hpp>
+#include <lo2s/perf/syscall/common.h>
+#include <lo2s/trace/fwd.hpp>
+#include <lo2s/types/thread.hpp>
+
+#include <otf2xx/chrono/time_point.hpp>
+
+#include <cstdint>
+
+namespace lo2s::perf::syscall
+{
+/**
+ * Writes the statistics the syscall BPF program accumulates for one syscall of one thread as a
+ * metric event (--syscall-histograms).
+ *
+ * All writers of a thread share its "syscall metrics" location, every syscall gets its own metric
+ * class with the count, the total time and the latency histogram.
+ */
+class HistogramWriter : public counter::MetricWriter
+{
+public:
+    HistogramWriter(Thread thread, int64_t syscall_nr, trace::Trace& trace);
+
+    /**
+     * Writes the stats, unless nothing happened since the last write.
+     */
+    void write(otf2::chrono::time_point tp, const struct syscall_stats& stats);
+
+private:
+    uint64_t last_count_ = 0;
+};
+} // namespace lo2s::perf::syscall
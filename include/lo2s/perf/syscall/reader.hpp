@@ -8,6 +8,7 @@
 #include <lo2s/execution_scope.hpp>
 #include <lo2s/log.hpp>
 #include <lo2s/perf/event_composer.hpp>
+#include <lo2s/perf/event_handover.hpp>
 #include <lo2s/perf/event_reader.hpp>
 #include <lo2s/perf/tracepoint/event_attr.hpp>
 
@@ -46,9 +47,13 @@ public:
 
     void stop()
     {
-        enter_ev_.disable();
-        // This should not be necessary because exit is attached to enter, but it can not hurt.
-        exit_ev_.disable();
+        // Events taken over by the next trace keep recording
+        if (!EventHandover::instance().active())
+        {
+            enter_ev_.disable();
+            // This should not be necessary because exit is attached to enter, but it can not hurt.
+            exit_ev_.disable();
+        }
 
         this->read();
     }
@@ -7,6 +7,7 @@
 #include <lo2s/config.hpp>
 #include <lo2s/log.hpp>
 #include <lo2s/perf/event_attr.hpp>
+#include <lo2s/perf/event_handover.hpp>
 #include <lo2s/perf/event_reader.hpp>
 #include <lo2s/perf/tracepoint/event_attr.hpp>
 #include <lo2s/perf/tracepoint/format.hpp>
@@ -95,7 +96,11 @@ public:
 
     void stop()
     {
-        ev_instance_.disable();
+        // Events taken over by the next trace keep recording
+        if (!EventHandover::instance().active())
+        {
+            ev_instance_.disable();
+        }
         this->read();
     }
 
@@ -7,6 +7,8 @@
 #include <lo2s/perf/time/converter.hpp>
 #include <lo2s/perf/tracepoint/event_attr.hpp>
 #include <lo2s/perf/tracepoint/reader.hpp>
+#include <lo2s/stream/stream.hpp>
+#include <lo2s/trace/budget.hpp>
 #include <lo2s/trace/fwd.hpp>
 #include <lo2s/types/cpu.hpp>
 
@@ -15,6 +17,8 @@
 #include <otf2xx/event/metric.hpp>
 #include <otf2xx/writer/local.hpp>
 
+#include <cstddef>
+
 namespace lo2s::perf::tracepoint
 {
 // Note, this cannot be protected for CRTP reasons...
@@ -43,5 +47,10 @@ private:
     const time::Converter time_converter_;
 
     otf2::event::metric metric_event_;
+
+    trace::Budget& budget_;
+    std::size_t num_events_ = 0;
+
+    stream::Writer stream_;
 };
 } // namespace lo2s::perf::tracepoint
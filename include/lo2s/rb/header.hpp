@@ -20,7 +20,8 @@ namespace lo2s
 // Increase everytime you:
 //  - change the ringbuf_header
 //  - add, delete or change events
-constexpr uint64_t RINGBUF_VERSION = 2;
+//  - change the layout of the shared memory
+constexpr uint64_t RINGBUF_VERSION = 3;
 
 enum class RingbufMeasurementType : uint64_t
 {
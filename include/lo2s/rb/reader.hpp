@@ -21,18 +21,21 @@ namespace lo2s
 class RingbufReader
 {
 public:
-    RingbufReader(clockid_t clockid);
+    // With huge_pages, the ring-buffer is backed by huge pages if there are enough available.
+    RingbufReader(clockid_t clockid, uint64_t pages = 16, bool huge_pages = false);
 
     RingbufReader(const RingbufReader&) = delete;
     RingbufReader& operator=(const RingbufReader& other) = delete;
 
-    RingbufReader(RingbufReader&& other) noexcept : rb_(std::move(other.rb_))
+    RingbufReader(RingbufReader&& other) noexcept
+    : rb_(std::move(other.rb_)), huge_pages_(other.huge_pages_)
     {
     }
 
     RingbufReader& operator=(RingbufReader&& other) noexcept
     {
         this->rb_ = std::move(other.rb_);
+        this->huge_pages_ = other.huge_pages_;
 
         return *this;
     }
@@ -69,6 +72,30 @@ public:
         return rb_->fd();
     }
 
+    // Number of bytes waiting to be read
+    uint64_t used()
+    {
+        const auto* rb_header = header();
+        return (rb_header->head.load() + rb_header->size - rb_header->tail.load()) %
+               rb_header->size;
+    }
+
+    uint64_t size()
+    {
+        return header()->size;
+    }
+
+    bool huge_pages() const
+    {
+        return huge_pages_;
+    }
+
+    // Prefer the NUMA node for the ring-buffer, call before the writer starts writing events
+    void prefer_numa_node(int node)
+    {
+        rb_->prefer_numa_node(node);
+    }
+
     uint64_t get_top_event_type();
     // Check if we can atleast load an event header, if not, there are no new events
     bool empty();
@@ -76,5 +103,6 @@ public:
 
 private:
     std::unique_ptr<ShmRingbuf> rb_;
+    bool huge_pages_ = false;
 };
 } // namespace lo2s
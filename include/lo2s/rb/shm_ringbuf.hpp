@@ -21,6 +21,9 @@ class ShmRingbuf
 {
 public:
     ShmRingbuf(int fd);
+
+    // The page size the ringbuffer in `fd` is mapped with, larger for huge pages
+    static size_t page_size(int fd);
     ShmRingbuf(ShmRingbuf&) = delete;
     ShmRingbuf& operator=(ShmRingbuf&) = delete;
 
@@ -61,6 +64,9 @@ public:
 
     bool can_be_loaded(size_t ev_size);
 
+    // Prefer the NUMA node for the pages of the ringbuffer that neither side has touched yet
+    void prefer_numa_node(int node);
+
     int fd() const
     {
         return fd_;
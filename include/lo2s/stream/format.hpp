@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace lo2s::stream
+{
+
+// Wire format of the live event stream (--stream).
+//
+// lo2s sends one SOCK_SEQPACKET message per batch. Every batch starts with a batch_header,
+// followed by batch_header.num_records records. Every record starts with a record_header,
+// record_header.size is the size of the whole record including the header.
+//
+// All records in a batch belong to the same source. The first batch of every source
+// starts with a SOURCE record naming it. Timestamps are in nanoseconds of the clock
+// selected with --clockid.
+//
+// Increase everytime you:
+//  - change the batch_header or record_header
+//  - add, delete or change records
+constexpr uint64_t STREAM_VERSION = 1;
+
+// Upper limit for the size of a single batch, including the batch_header
+constexpr std::size_t MAX_BATCH_SIZE = 16384;
+
+enum class RecordType : uint32_t
+{
+    SOURCE = 1,
+    CCTX = 2,
+    CCTX_ENTER = 3,
+    CCTX_LEAVE = 4,
+    CCTX_SAMPLE = 5,
+    METRIC = 6,
+    IO_BEGIN = 7,
+    IO_COMPLETE = 8,
+};
+
+enum class SourceType : uint64_t
+{
+    CCTX_TREE = 1,
+    METRIC = 2,
+    IO = 3,
+};
+
+struct batch_header
+{
+    uint64_t version;
+    uint64_t source;
+    uint64_t num_records;
+    uint64_t size;
+};
+
+struct record_header
+{
+    uint32_t type;
+    uint32_t size;
+    uint64_t time;
+};
+
+struct source_record
+{
+    struct record_header header;
+    uint64_t type;
+    char name[64];
+};
+
+// Definition of a new node in the calling context tree of the source. Refs are local to the
+// source, the root node of every tree has the ref 0 and is never sent.
+struct cctx_record
+{
+    struct record_header header;
+    uint64_t ref;
+    uint64_t parent_ref;
+    // lo2s::CallingContextType
+    uint64_t type;
+    // process id, thread id, instruction address, GPU kernel id or syscall number
+    uint64_t value;
+};
+
+// CCTX_ENTER, CCTX_LEAVE, CCTX_SAMPLE
+struct cctx_event_record
+{
+    struct record_header header;
+    uint64_t ref;
+};
+
+// Followed by num_values raw 64 bit values, typed as in the metric class of the
+// corresponding metric in the OTF2 trace
+struct metric_record
+{
+    struct record_header header;
+    uint64_t num_values;
+};
+
+// IO_BEGIN, IO_COMPLETE
+struct io_record
+{
+    struct record_header header;
+    // OTF2 reference of the I/O handle
+    uint64_t handle;
+    // otf2::common::io_operation_mode_type
+    uint64_t mode;
+    uint64_t bytes;
+    uint64_t matching_id;
+};
+
+} // namespace lo2s::stream
@@ -0,0 +1,174 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <lo2s/calling_context.hpp>
+#include <lo2s/stream/format.hpp>
+
+#include <otf2xx/chrono/time_point.hpp>
+#include <otf2xx/event/metric.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace lo2s::stream
+{
+class Writer;
+
+/**
+ * Connection to a local consumer of the live event stream.
+ *
+ * lo2s connects to the SOCK_SEQPACKET unix domain socket given with --stream, the consumer has
+ * to listen on it before lo2s is started. Batches are sent without blocking, if the consumer
+ * can not keep up, batches are dropped instead of slowing down the monitoring threads.
+ */
+class Stream
+{
+public:
+    Stream(const std::string& path);
+    ~Stream();
+
+    Stream(Stream&) = delete;
+    Stream(Stream&&) = delete;
+    Stream& operator=(Stream&) = delete;
+    Stream& operator=(Stream&&) = delete;
+
+    bool enabled() const
+    {
+        return connected_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t register_source()
+    {
+        return next_source_++;
+    }
+
+    void submit(const std::byte* batch, std::size_t size);
+
+    std::size_t dropped_batches() const
+    {
+        return dropped_batches_;
+    }
+
+    /**
+     * Send the batches of the Writers last written to by the calling thread that are at least
+     * Writer::FLUSH_INTERVAL old.
+     *
+     * Returns the time until the next of them is due, if there are any left.
+     */
+    std::optional<std::chrono::milliseconds> flush_due();
+
+    // Send the batches of all the Writers last written to by the calling thread
+    void flush_all();
+
+private:
+    friend class Writer;
+
+    void add_pending(Writer* writer, std::thread::id thread);
+    void remove_pending(Writer* writer, std::thread::id thread);
+
+    int fd_ = -1;
+    std::atomic_bool connected_ = false;
+    std::atomic<uint64_t> next_source_ = 0;
+    std::atomic<std::size_t> dropped_batches_ = 0;
+
+    // Writers with a batch that is not sent yet, by the thread that started the batch. Writers may
+    // be destroyed by another thread than the one that wrote to them, so this is not thread_local.
+    std::mutex pending_mutex_;
+    std::map<std::thread::id, std::set<Writer*>> pending_;
+};
+
+/**
+ * Collects the records of a single source into batches.
+ *
+ * Like the otf2::writer::local it is used with, a Writer must only be used by a single thread.
+ * Batches are sent once they are full or FLUSH_INTERVAL old. To also send the batches of idle
+ * sources, the monitor threads call Stream::flush_due() whenever they wake up.
+ */
+class Writer
+{
+public:
+    // Send incomplete batches after this time to keep the stream live
+    static constexpr std::chrono::milliseconds FLUSH_INTERVAL{ 100 };
+
+    Writer(Stream& stream, SourceType type, const std::string& name);
+    ~Writer();
+
+    Writer(Writer&) = delete;
+    Writer(Writer&&) = delete;
+    Writer& operator=(Writer&) = delete;
+    Writer& operator=(Writer&&) = delete;
+
+    bool enabled() const
+    {
+        return stream_.enabled();
+    }
+
+    void cctx(uint64_t ref, uint64_t parent_ref, const CallingContext& cctx);
+
+    void cctx_enter(otf2::chrono::time_point tp, uint64_t ref)
+    {
+        if (enabled())
+        {
+            cctx_event(RecordType::CCTX_ENTER, tp, ref);
+        }
+    }
+
+    void cctx_leave(otf2::chrono::time_point tp, uint64_t ref)
+    {
+        if (enabled())
+        {
+            cctx_event(RecordType::CCTX_LEAVE, tp, ref);
+        }
+    }
+
+    void cctx_sample(otf2::chrono::time_point tp, uint64_t ref)
+    {
+        if (enabled())
+        {
+            cctx_event(RecordType::CCTX_SAMPLE, tp, ref);
+        }
+    }
+
+    void metric(const otf2::event::metric& event);
+
+    void io(RecordType type, otf2::chrono::time_point tp, uint64_t handle, uint64_t mode,
+            uint64_t bytes, uint64_t matching_id);
+
+    void flush();
+
+private:
+    friend class Stream;
+
+    void cctx_event(RecordType type, otf2::chrono::time_point tp, uint64_t ref);
+
+    template <class T>
+    T* append(RecordType type, otf2::chrono::time_point tp, std::size_t payload = 0);
+
+    Stream& stream_;
+    uint64_t source_;
+    bool source_sent_ = false;
+
+    SourceType type_;
+    std::string name_;
+
+    std::vector<std::byte> batch_;
+    uint64_t num_records_ = 0;
+    std::chrono::steady_clock::time_point batch_start_;
+
+    // Thread that started the batch, see Stream::pending_
+    std::optional<std::thread::id> pending_in_;
+};
+} // namespace lo2s::stream
@@ -30,6 +30,12 @@ public:
     void set_exit_code(int exit_code);
     void set_trace_dir(const std::string& trace_dir);
 
+    // Account bytes written to the files of the trace
+    void add_written_bytes(std::size_t bytes);
+
+    // Log the amount of data written to the trace so far
+    void report_trace_size() const;
+
     friend Summary& summary();
 
 private:
@@ -39,6 +45,7 @@ private:
 
     std::atomic<std::size_t> num_wakeups_;
     std::atomic<std::size_t> thread_count_;
+    std::atomic<std::size_t> written_bytes_;
 
     std::set<Process> processes_;
     std::mutex processes_mutex_;
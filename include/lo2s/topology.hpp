@@ -70,11 +70,44 @@ public:
         return Cpu::invalid();
     }
 
+    const std::set<int>& numa_nodes() const
+    {
+        return numa_nodes_;
+    }
+
+    /**
+     * NUMA node the cpu belongs to, -1 if the kernel does not report any NUMA topology.
+     */
+    int numa_node_of(Cpu cpu) const
+    {
+        auto it = cpu_to_numa_node_.find(cpu);
+        if (it == cpu_to_numa_node_.end())
+        {
+            return -1;
+        }
+        return it->second;
+    }
+
+    std::set<Cpu> cpus_of_numa_node(int node) const
+    {
+        std::set<Cpu> result;
+        for (const auto& [cpu, cpu_node] : cpu_to_numa_node_)
+        {
+            if (cpu_node == node)
+            {
+                result.emplace(cpu);
+            }
+        }
+        return result;
+    }
+
 private:
     std::set<Cpu> cpus_;
     std::set<Package> packages_;
     std::map<Cpu, Core> cpu_to_core_;
     std::map<Cpu, Package> cpu_to_package_;
+    std::set<int> numa_nodes_;
+    std::map<Cpu, int> cpu_to_numa_node_;
 
     bool hypervised_ = false;
 };
@@ -0,0 +1,178 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <lo2s/overhead.hpp>
+
+#include <otf2xx/chrono/time_point.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace lo2s::trace
+{
+/**
+ * Ways in which lo2s reduces its output once the trace budget is (almost) exhausted.
+ *
+ * The levels are ordered, every level implies all the degradations of the levels below it.
+ */
+enum class Degradation : std::int64_t
+{
+    NONE = 0,
+    // sampling writers increase their sampling period
+    REDUCED_SAMPLING = 1,
+    // sampling writers only record the instruction pointer of a sample
+    NO_CALLCHAINS = 2,
+    // metric writers only write every DECIMATION_FACTOR-th metric event
+    DECIMATED_METRICS = 3,
+    // samples, metrics and I/O operations are discarded
+    DROPPING = 4,
+};
+
+std::string to_string(Degradation level);
+
+/**
+ * Online accounting of the (estimated) amount of data written to the trace.
+ *
+ * Writers report every event they write with account() and check the current degradation
+ * level() to decide how much to write. The level is derived from the share of the size limit
+ * (--max-trace-size) that is already used up and from the share of the rate limit
+ * (--max-trace-rate) used up in the current one second window, whichever is worse.
+ *
+ * The exact size of an OTF2 event is only known once it is encoded and compressed by OTF2, so
+ * the accounting uses conservative per-event estimates instead.
+ *
+ * The written size is always tracked, also without any limits, as the size based trace rotation
+ * (--rotate-size) relies on it. To keep this cheap for many concurrent writers,
+ * the running total is split into per-thread shards. Summing up the shards is only done after a
+ * thread accounted another SIZE_CHECK_INTERVAL bytes, so every thread may overshoot the size limit
+ * by at most that much before the degradation level is raised.
+ */
+class Budget
+{
+public:
+    // estimated size of an event record without any metric values
+    static constexpr std::size_t EVENT_SIZE = 16;
+    // estimated size of a single value inside of a metric event
+    static constexpr std::size_t METRIC_VALUE_SIZE = 9;
+    // bytes a thread accounts before the size limit is checked again
+    static constexpr std::size_t SIZE_CHECK_INTERVAL = 64 * 1024;
+
+    static constexpr std::uint64_t SAMPLING_PERIOD_FACTOR = 4;
+    static constexpr std::size_t DECIMATION_FACTOR = 10;
+
+    Budget(std::size_t max_size, std::size_t max_rate);
+
+    Budget(Budget&) = delete;
+    Budget(Budget&&) = delete;
+    Budget& operator=(Budget&) = delete;
+    Budget& operator=(Budget&&) = delete;
+
+    bool enabled() const
+    {
+        return max_size_ != 0 || max_rate_ != 0;
+    }
+
+    Degradation level() const
+    {
+        return level_.load(std::memory_order_relaxed);
+    }
+
+    bool degraded(Degradation level) const
+    {
+        return this->level() >= level;
+    }
+
+    /**
+     * Report that an event of an estimated size of `bytes` was written.
+     */
+    void account(std::size_t bytes)
+    {
+        written_shard().fetch_add(bytes, std::memory_order_relaxed);
+        Overhead::thread().bytes += bytes;
+        if (enabled())
+        {
+            update(bytes);
+        }
+    }
+
+    void account_metric(std::size_t num_values)
+    {
+        account(EVENT_SIZE + num_values * METRIC_VALUE_SIZE);
+    }
+
+    /**
+     * Report that an event was discarded because of the budget.
+     */
+    void drop()
+    {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::size_t written() const
+    {
+        return std::accumulate(written_.begin(), written_.end(), std::size_t(0),
+                               [](std::size_t sum, const WrittenShard& shard) {
+                                   return sum + shard.bytes.load(std::memory_order_relaxed);
+                               });
+    }
+
+    std::size_t dropped() const
+    {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    Degradation max_level() const;
+
+    std::vector<std::pair<otf2::chrono::time_point, Degradation>> transitions() const;
+
+private:
+    static constexpr std::size_t WRITTEN_SHARDS = 32;
+
+    // Own cache line per shard, so that writers on different threads do not contend
+    struct alignas(64) WrittenShard
+    {
+        std::atomic<std::size_t> bytes = 0;
+    };
+
+    std::atomic<std::size_t>& written_shard()
+    {
+        static thread_local const std::size_t index =
+            std::hash<std::thread::id>{}(std::this_thread::get_id()) % WRITTEN_SHARDS;
+        return written_[index].bytes;
+    }
+
+    void update(std::size_t bytes);
+
+    Degradation level_for(std::size_t used, std::size_t limit) const;
+
+    const std::size_t max_size_;
+    const std::size_t max_rate_;
+
+    std::atomic<Degradation> level_ = Degradation::NONE;
+    // level for the size limit at the last check
+    std::atomic<Degradation> size_level_ = Degradation::NONE;
+
+    std::array<WrittenShard, WRITTEN_SHARDS> written_;
+    std::atomic<std::size_t> dropped_ = 0;
+
+    std::atomic<std::size_t> window_written_ = 0;
+    std::atomic<std::chrono::steady_clock::rep> window_start_;
+
+    mutable std::mutex mutex_;
+    std::vector<std::pair<otf2::chrono::time_point, Degradation>> transitions_;
+};
+} // namespace lo2s::trace
@@ -15,6 +15,8 @@
 #include <lo2s/perf/event_composer.hpp>
 #include <lo2s/perf/tracepoint/event_attr.hpp>
 #include <lo2s/resolvers.hpp>
+#include <lo2s/stream/stream.hpp>
+#include <lo2s/trace/budget.hpp>
 #include <lo2s/trace/reg_keys.hpp>
 #include <lo2s/types/core.hpp>
 #include <lo2s/types/cpu.hpp>
@@ -43,17 +45,21 @@
 #include <otf2xx/writer/archive.hpp>
 #include <otf2xx/writer/local.hpp>
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <deque>
+#include <initializer_list>
 #include <map>
 #include <mutex>
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include <cstddef>
 #include <cstdint>
 
 #include <sched.h>
@@ -100,6 +106,22 @@ public:
     otf2::writer::local& create_metric_writer(const std::string& name);
     otf2::writer::local& posix_io_writer(Thread thread);
 
+    Budget& budget()
+    {
+        return budget_;
+    }
+
+    stream::Stream& stream()
+    {
+        return stream_;
+    }
+
+    /**
+     * Called by OTF2 after the buffer of a file of the archive was flushed, hands the bytes that
+     * were added to that file to the summary.
+     */
+    void account_flush(int file_type, std::uint64_t location);
+
     otf2::definition::io_handle& block_io_handle(BlockDevice dev);
     otf2::definition::io_handle& posix_io_handle(Thread thread, int fd, int instance,
                                                  std::string& name);
@@ -135,12 +157,67 @@ public:
         return cpuid_metric_class_;
     }
 
+    otf2::definition::metric_class sampling_period_metric_class()
+    {
+        if (!sampling_period_metric_class_)
+        {
+            sampling_period_metric_class_ = registry_.create<otf2::definition::metric_class>(
+                otf2::common::metric_occurence::async, otf2::common::recorder_kind::abstract);
+            sampling_period_metric_class_->add_member(
+                metric_member("sampling period", "Events between two samples",
+                              otf2::common::metric_mode::absolute_point,
+                              otf2::common::type::uint64, "#"));
+        }
+        return sampling_period_metric_class_;
+    }
+
+    // Metrics of the self-overhead of a monitor thread, see monitor::OverheadRecorder
+    otf2::definition::metric_class overhead_metric_class()
+    {
+        std::lock_guard<std::recursive_mutex> const guard(mutex_);
+
+        if (!overhead_metric_class_)
+        {
+            overhead_metric_class_ = registry_.create<otf2::definition::metric_class>(
+                otf2::common::metric_occurence::async, otf2::common::recorder_kind::abstract);
+            overhead_metric_class_->add_member(
+                metric_member("wakeups", "Wakeups of the monitor thread",
+                              otf2::common::metric_mode::absolute_point,
+                              otf2::common::type::Double, "1/s"));
+            overhead_metric_class_->add_member(
+                metric_member("records per drain", "Records read per buffer drain",
+                              otf2::common::metric_mode::absolute_point,
+                              otf2::common::type::Double, "#"));
+            overhead_metric_class_->add_member(
+                metric_member("drain latency", "Time spent handling events per wakeup",
+                              otf2::common::metric_mode::absolute_point,
+                              otf2::common::type::Double, "us"));
+            overhead_metric_class_->add_member(
+                metric_member("bytes written", "Estimated trace data written by the thread",
+                              otf2::common::metric_mode::absolute_point,
+                              otf2::common::type::Double, "B/s"));
+            overhead_metric_class_->add_member(
+                metric_member("cpu usage", "CPU time used by the monitor thread",
+                              otf2::common::metric_mode::absolute_point,
+                              otf2::common::type::Double, "%"));
+            overhead_metric_class_->add_member(
+                metric_member("buffer fill", "Highest buffer fill level at drain time",
+                              otf2::common::metric_mode::absolute_point,
+                              otf2::common::type::Double, "%"));
+        }
+        return overhead_metric_class_;
+    }
+
+    // accumulated_last with --metric-deltas, as the values are then the differences to the
+    // previous event
+    otf2::common::metric_mode perf_metric_mode() const;
+
     otf2::definition::metric_member& get_event_metric_member(const perf::EventAttr& event)
     {
         return registry_.emplace<otf2::definition::metric_member>(
             BySamplingEvent(event), intern(event.name()), intern(event.name()),
-            otf2::common::metric_type::other, otf2::common::metric_mode::accumulated_start,
-            otf2::common::type::Double, otf2::common::base_type::decimal, 0, intern(event.unit()));
+            otf2::common::metric_type::other, perf_metric_mode(), otf2::common::type::Double,
+            otf2::common::base_type::decimal, 0, intern(event.unit()));
     }
 
     otf2::definition::metric_class& perf_metric_class(MeasurementScope scope)
@@ -222,24 +299,47 @@ public:
         {
             auto& enabled_metric_member = registry_.emplace<otf2::definition::metric_member>(
                 ByString("time_enabled"), intern("time_enabled"), intern("time event active"),
-                otf2::common::metric_type::other, otf2::common::metric_mode::accumulated_start,
-                otf2::common::type::uint64, otf2::common::base_type::decimal, 0, intern("ns"));
+                otf2::common::metric_type::other, perf_metric_mode(), otf2::common::type::uint64,
+                otf2::common::base_type::decimal, 0, intern("ns"));
 
             metric_class.add_member(enabled_metric_member);
 
             auto& running_metric_member = registry_.emplace<otf2::definition::metric_member>(
                 ByString("time_running"), intern("time_running"), intern("time event on CPU"),
-                otf2::common::metric_type::other, otf2::common::metric_mode::accumulated_start,
-                otf2::common::type::uint64, otf2::common::base_type::decimal, 0, intern("ns"));
+                otf2::common::metric_type::other, perf_metric_mode(), otf2::common::type::uint64,
+                otf2::common::base_type::decimal, 0, intern("ns"));
 
             metric_class.add_member(running_metric_member);
         }
+
+        if (!counter_collection.group_starts.empty())
+        {
+            auto& group_metric_member = registry_.emplace<otf2::definition::metric_member>(
+                ByString("active_group"), intern("active_group"),
+                intern("group of metric events counted before this event"),
+                otf2::common::metric_type::other, otf2::common::metric_mode::absolute_point,
+                otf2::common::type::Double, otf2::common::base_type::decimal, 0, intern("#"));
+
+            metric_class.add_member(group_metric_member);
+
+            auto& coverage_metric_member = registry_.emplace<otf2::definition::metric_member>(
+                ByString("group_coverage"), intern("group_coverage"),
+                intern("share of the measurement in which the active group was counting"),
+                otf2::common::metric_type::other, otf2::common::metric_mode::absolute_point,
+                otf2::common::type::Double, otf2::common::base_type::decimal, 0, intern("%"));
+
+            metric_class.add_member(coverage_metric_member);
+        }
         return metric_class;
     }
 
     otf2::definition::metric_class&
     tracepoint_metric_class(const perf::tracepoint::TracepointEventAttr& event);
 
+    // count, total time and latency histogram of a syscall, for --syscall-histograms
+    otf2::definition::metric_class& syscall_metric_class(int64_t syscall_nr,
+                                                         std::size_t histogram_buckets);
+
     const otf2::definition::interrupt_generator& interrupt_generator() const
     {
         return interrupt_generator_;
@@ -309,6 +409,10 @@ private:
                      GlobalCctxMap::value_type* global_node, std::vector<uint32_t>& mapping_table,
                      Resolvers& resolvers, struct MergeContext& ctx);
 
+    // Write the summed up --sample-counter deltas and --memory-sampling data accesses as
+    // properties of the calling contexts below node
+    void write_sample_properties(const GlobalCctxMap::value_type& node);
+
     otf2::definition::system_tree_node bio_parent_node(BlockDevice& device)
     {
         if (device.type == BlockDeviceType::PARTITION)
@@ -333,8 +437,16 @@ private:
 
     const otf2::definition::string& intern(const std::string& /*name*/);
 
+    /**
+     * Intern several strings at once, taking the registry lock only once for all the strings
+     * which are not yet known.
+     */
+    void intern_all(std::initializer_list<const std::string*> names);
+
     void add_lo2s_property(const std::string& name, const std::string& value);
 
+    void write_budget_degradations();
+
     static constexpr pid_t METRIC_PID = 0;
 
     std::string trace_name_;
@@ -345,6 +457,27 @@ private:
 
     std::recursive_mutex mutex_;
 
+    /**
+     * Concurrent lookup table in front of the string definitions in the registry.
+     *
+     * Looking up an already interned string only locks the shard the string hashes to, the
+     * registry lock (#mutex_) is only taken to create new string definitions. Registry
+     * definitions are never moved, so the shards can hand out references to them.
+     */
+    struct InternShard
+    {
+        std::mutex mutex;
+        std::unordered_map<std::string, const otf2::definition::string*> strings;
+    };
+
+    static constexpr std::size_t INTERN_SHARDS = 64;
+
+    InternShard& intern_shard(const std::string& name);
+
+    const otf2::definition::string* lookup_interned(InternShard& shard, const std::string& name);
+
+    std::array<InternShard, INTERN_SHARDS> intern_shards_;
+
     otf2::chrono::time_point starting_time_;
     std::chrono::system_clock::time_point starting_system_time_;
     otf2::chrono::time_point stopping_time_;
@@ -364,6 +497,9 @@ private:
     otf2::definition::regions_group& kernel_regions_group_;
 
     otf2::definition::detail::weak_ref<otf2::definition::metric_class> cpuid_metric_class_;
+    otf2::definition::detail::weak_ref<otf2::definition::metric_class>
+        sampling_period_metric_class_;
+    otf2::definition::detail::weak_ref<otf2::definition::metric_class> overhead_metric_class_;
     std::map<std::set<Cpu>, otf2::definition::detail::weak_ref<otf2::definition::metric_class>>
         perf_group_metric_classes_;
     std::map<std::set<Cpu>, otf2::definition::detail::weak_ref<otf2::definition::metric_class>>
@@ -380,6 +516,14 @@ private:
 
     ExecutionScopeGroup& groups_;
 
+    Budget budget_;
+
+    // Size of every file of the archive after its last flush, by OTF2 file type and location
+    std::mutex flushed_sizes_mutex_;
+    std::map<std::pair<int, std::uint64_t>, std::size_t> flushed_sizes_;
+
+    stream::Stream stream_;
+
     std::deque<LocalCctxTree> local_cctx_trees_;
     // Mutex is only used for accessing the cctx_refs_
     std::mutex local_cctx_trees_mutex_;
@@ -57,7 +57,14 @@ public:
     std::shared_ptr<T> operator[](const std::string& name)
     {
         const std::lock_guard<std::mutex> guard(mutex_);
-        return elements_.try_emplace(name, std::make_shared<T>(name)).first->second;
+        auto it = elements_.find(name);
+        if (it == elements_.end())
+        {
+            // Only construct new elements, constructing e.g. a DwarfFunctionResolver loads the
+            // whole binary
+            it = elements_.emplace(name, std::make_shared<T>(name)).first;
+        }
+        return it->second;
     }
 
 private:
@@ -192,6 +192,15 @@ void Config::check() const
         std::exit(EXIT_FAILURE);
     }
 
+    if ((otf2.rotate_interval.count() != 0 || otf2.rotate_size != 0) &&
+        (general.monitor_type != lo2s::MonitorType::CPU_SET || !put.command.empty() ||
+         general.process != Process::invalid()))
+    {
+        Log::fatal() << "Trace rotation can only be used in system-wide monitoring mode without a "
+                        "COMMAND or PID.";
+        std::exit(EXIT_FAILURE);
+    }
+
     if (general.monitor_type == lo2s::MonitorType::CPU_SET && perf.posix_io.enabled)
     {
         Log::fatal() << "POSIX I/O recording can only be enabled in process monitoring mode.";
@@ -27,6 +27,21 @@ AcceleratorConfig::AcceleratorConfig(nitro::options::arguments& arguments)
     nec_check_interval =
         std::chrono::milliseconds(arguments.as<std::uint64_t>("nec-check-interval"));
 
+    cupti_buffer_size = arguments.as<std::uint64_t>("cupti-buffer-size") * 1024 * 1024;
+    cupti_buffer_count = arguments.as<std::uint64_t>("cupti-buffers");
+
+    if (cupti_buffer_size == 0)
+    {
+        std::cerr << "--cupti-buffer-size must be at least 1 MiB\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    if (cupti_buffer_count == 0)
+    {
+        std::cerr << "--cupti-buffers must be at least 1\n";
+        std::exit(EXIT_FAILURE);
+    }
+
     for (const auto& accel : arguments.get_all("accel"))
     {
         if (accel == "nvidia")
@@ -91,6 +106,15 @@ void AcceleratorConfig::add_parser(nitro::options::parser& parser)
         .optional()
         .metavar("MSEC")
         .default_value("100");
+    accel_options.option("cupti-buffer-size", "Size of the CUPTI activity buffers")
+        .optional()
+        .metavar("MIB")
+        .default_value("8");
+    accel_options
+        .option("cupti-buffers", "Number of CUPTI activity buffers kept for reuse once completed")
+        .optional()
+        .metavar("N")
+        .default_value("4");
 }
 
 void to_json(nlohmann::json& j, const AcceleratorConfig& config)
@@ -100,6 +124,8 @@ void to_json(nlohmann::json& j, const AcceleratorConfig& config)
                          { "hip", config.hip },
                          { "nec", config.nec },
                          { "nec_read_interval", config.nec_read_interval.count() },
-                         { "nec_check_interval", config.nec_check_interval.count() } });
+                         { "nec_check_interval", config.nec_check_interval.count() },
+                         { "cupti_buffer_size", config.cupti_buffer_size },
+                         { "cupti_buffer_count", config.cupti_buffer_count } });
 }
 } // namespace lo2s
@@ -13,6 +13,7 @@
 
 #include <string>
 
+#include <cstdint>
 #include <cstdlib>
 
 namespace lo2s
@@ -47,6 +48,13 @@ DwarfConfig::DwarfConfig(nitro::options::arguments& arguments)
         Log::error() << "Unknown DWARF mode: " << dwarf_mode;
         std::exit(EXIT_FAILURE);
     }
+
+    debuginfod_jobs = arguments.as<std::uint64_t>("debuginfod-jobs");
+    if (debuginfod_jobs == 0)
+    {
+        Log::error() << "--debuginfod-jobs has to be at least 1!";
+        std::exit(EXIT_FAILURE);
+    }
 }
 
 void DwarfConfig::add_parser(nitro::options::parser& parser)
@@ -58,6 +66,13 @@ void DwarfConfig::add_parser(nitro::options::parser& parser)
                 "debuginfo files, 'full' uses debuginfod to download debug information on demand")
         .default_value("local")
         .metavar("DWARFMODE");
+
+    dwarf_options
+        .option("debuginfod-jobs",
+                "Number of debug information files that are downloaded concurrently with "
+                "--dwarf full.")
+        .default_value("4")
+        .metavar("N");
 }
 
 void DwarfConfig::check()
@@ -80,6 +95,7 @@ NLOHMANN_JSON_SERIALIZE_ENUM(DwarfUsage, { { DwarfUsage::NONE, "none" },
 
 void to_json(nlohmann::json& j, const DwarfConfig& config)
 {
-    j = nlohmann::json({ { "usage", config.usage } });
+    j = nlohmann::json(
+        { { "usage", config.usage }, { "debuginfod_jobs", config.debuginfod_jobs } });
 }
 } // namespace lo2s
@@ -8,11 +8,26 @@
 #include <nitro/options/parser.hpp>
 #include <nlohmann/json.hpp>
 
+#include <chrono>
+
+#include <cstddef>
+#include <cstdint>
+
 namespace lo2s
 {
 Otf2Config::Otf2Config(nitro::options::arguments& arguments)
-: trace_path(arguments.get("output-trace"))
+: trace_path(arguments.get("output-trace")),
+  max_trace_size(arguments.as<std::size_t>("max-trace-size") * 1024 * 1024),
+  max_trace_rate(arguments.as<std::size_t>("max-trace-rate") * 1024 * 1024),
+  rotate_interval(arguments.as<std::uint64_t>("rotate-interval")),
+  rotate_size(arguments.as<std::size_t>("rotate-size") * 1024 * 1024),
+  report_size_interval(arguments.as<std::uint64_t>("report-trace-size")),
+  overhead_metrics(arguments.given("overhead-metrics"))
 {
+    if (arguments.provided("stream"))
+    {
+        stream_path = arguments.get("stream");
+    }
 }
 
 void Otf2Config::add_parser(nitro::options::parser& parser)
@@ -22,10 +37,58 @@ void Otf2Config::add_parser(nitro::options::parser& parser)
         .default_value("lo2s_trace_{DATE}")
         .env("LO2S_OUTPUT_TRACE")
         .short_name("o");
+
+    trace_options
+        .option("max-trace-size", "Upper limit for the size of the trace. lo2s reduces the amount "
+                                  "of recorded data when approaching it. (0: unlimited)")
+        .default_value("0")
+        .metavar("MIB");
+
+    trace_options
+        .option("max-trace-rate", "Upper limit for the amount of trace data written per second. "
+                                  "(0: unlimited)")
+        .default_value("0")
+        .metavar("MIB");
+
+    trace_options
+        .option("rotate-interval", "Close the trace and continue recording into a new one "
+                                   "every SEC seconds. Only for system-wide monitoring "
+                                   "without a COMMAND. (0: disabled)")
+        .default_value("0")
+        .metavar("SEC");
+
+    trace_options
+        .option("rotate-size", "Close the trace and continue recording into a new one once "
+                               "it reaches a size of MIB. Only for system-wide monitoring "
+                               "without a COMMAND. (0: disabled)")
+        .default_value("0")
+        .metavar("MIB");
+
+    trace_options
+        .option("report-trace-size", "Print the size of the trace written so far every SEC "
+                                     "seconds. (0: disabled)")
+        .default_value("0")
+        .metavar("SEC");
+
+    trace_options.toggle("overhead-metrics",
+                         "Record the overhead of every lo2s monitor thread as metrics.");
+
+    trace_options
+        .option("stream", "Additionally stream events to a consumer listening on the unix "
+                          "domain socket PATH.")
+        .optional()
+        .metavar("PATH");
 }
 
 void to_json(nlohmann::json& j, const Otf2Config& config)
 {
-    j = nlohmann::json({ { "trace_path", config.trace_path } });
+    j = nlohmann::json({ { "trace_path", config.trace_path },
+                         { "max_trace_size", config.max_trace_size },
+                         { "max_trace_rate", config.max_trace_rate },
+                         { "rotate_interval", config.rotate_interval.count() },
+                         { "rotate_size", config.rotate_size },
+                         { "report_size_interval", config.report_size_interval.count() },
+                         { "overhead_metrics", config.overhead_metrics },
+                         { "stream_path", config.stream_path } });
 }
 } // namespace lo2s
@@ -4,6 +4,7 @@
 
 #include <lo2s/config/perf/sampling_config.hpp>
 
+#include <lo2s/dwarf_unwind.hpp>
 #include <lo2s/log.hpp>
 #include <lo2s/perf/event_resolver.hpp>
 #include <lo2s/perf/util.hpp>
@@ -13,8 +14,10 @@
 #include <nitro/options/parser.hpp>
 #include <nlohmann/json.hpp>
 
+#include <chrono>
 #include <iostream>
 #include <ostream>
+#include <string>
 
 #include <cstdint>
 #include <cstdlib>
@@ -45,9 +48,17 @@ SamplingConfig::SamplingConfig(nitro::options::arguments& arguments)
         process_recording = arguments.given("process-recording");
     }
     exclude_kernel = !static_cast<bool>(arguments.given("kernel"));
-    enable_callgraph = arguments.given("call-graph");
+    dwarf_unwinding = arguments.given("dwarf-unwinding");
+    // DWARF unwinding is just a different way to get the call graph
+    enable_callgraph = arguments.given("call-graph") || dwarf_unwinding;
+    unwind_stack_size = arguments.as<std::uint32_t>("unwind-stack-size");
     period = arguments.as<std::uint64_t>("count");
+    adaptive_rate = arguments.as<std::uint64_t>("adaptive-sampling");
     event = arguments.get("event");
+    counters = arguments.get_all("sample-counter");
+    memory_sampling = arguments.given("memory-sampling");
+    off_cpu = arguments.given("off-cpu");
+    off_cpu_threshold = std::chrono::microseconds(arguments.as<std::uint64_t>("off-cpu-threshold"));
 }
 
 void SamplingConfig::add_parser(nitro::options::parser& parser)
@@ -69,12 +80,52 @@ void SamplingConfig::add_parser(nitro::options::parser& parser)
         .default_value("11010113")
         .metavar("N");
 
+    sampling_options
+        .option("adaptive-sampling",
+                "Continuously adjust the sampling period to record about HZ samples per second "
+                "(0 = disabled).")
+        .default_value("0")
+        .metavar("HZ");
+
+    sampling_options
+        .multi_option("sample-counter",
+                      "Read this perf event with every sample and attribute the difference to "
+                      "the previous sample to the sampled calling context.")
+        .optional()
+        .metavar("EVENT");
+
     sampling_options.toggle("call-graph", "Record call stack of instruction samples.")
         .short_name("g");
 
+    sampling_options.toggle("dwarf-unwinding",
+                            "Unwind the user space call stack of instruction samples with the "
+                            "DWARF call frame information instead of frame pointers. Implies -g.");
+
+    sampling_options
+        .option("unwind-stack-size",
+                "Size of the user space stack snapshot taken with every sample for DWARF "
+                "unwinding.")
+        .default_value("8192")
+        .metavar("BYTES");
+
+    sampling_options.toggle(
+        "memory-sampling",
+        "Record the accessed data address with every sample and attribute the samples to the "
+        "accessed data objects. Requires an event that reports data addresses, such as "
+        "page-faults or the memory access events of the CPU.");
+
     sampling_options.toggle("no-ip",
                             "Do not record instruction pointers [NOT CURRENTLY SUPPORTED]");
 
+    sampling_options.toggle("off-cpu",
+                            "Record the intervals in which threads are blocked, together with the "
+                            "call stack they blocked in. Requires BPF.");
+
+    sampling_options
+        .option("off-cpu-threshold", "Only record blocked intervals of at least USEC microseconds.")
+        .default_value("0")
+        .metavar("USEC");
+
     sampling_options.toggle("kernel", "Include events happening in kernel space.")
         .allow_reverse()
         .default_value(true);
@@ -103,6 +154,54 @@ void SamplingConfig::check()
         lo2s::Log::fatal() << "requested sampling event \'" << event << "\' is not available!";
         std::exit(EXIT_FAILURE); // hmm...
     }
+    if (!counters.empty() && !enabled)
+    {
+        lo2s::Log::fatal() << "--sample-counter requires instruction sampling to be enabled!";
+        std::exit(EXIT_FAILURE);
+    }
+    for (const auto& counter : counters)
+    {
+        if (!perf::EventResolver::instance().has_event(counter))
+        {
+            lo2s::Log::fatal() << "requested sample counter \'" << counter
+                               << "\' is not available!";
+            std::exit(EXIT_FAILURE);
+        }
+    }
+    if (memory_sampling && !enabled)
+    {
+        lo2s::Log::fatal() << "--memory-sampling requires instruction sampling to be enabled!";
+        std::exit(EXIT_FAILURE);
+    }
+    if (dwarf_unwinding)
+    {
+        if (!DwarfUnwinder::supported())
+        {
+            lo2s::Log::fatal() << "--dwarf-unwinding is not supported on this architecture!";
+            std::exit(EXIT_FAILURE);
+        }
+        // The kernel only accepts 8 byte aligned stack sizes that fit into the u16 size of a
+        // sample record
+        if (unwind_stack_size == 0 || unwind_stack_size % 8 != 0 || unwind_stack_size > 65528)
+        {
+            lo2s::Log::fatal() << "--unwind-stack-size has to be a multiple of 8 between 8 and "
+                                  "65528!";
+            std::exit(EXIT_FAILURE);
+        }
+    }
+    if (off_cpu)
+    {
+        if (!enabled)
+        {
+            // Without the sample writers, the memory mappings to resolve the callchains are missing
+            lo2s::Log::fatal() << "--off-cpu requires instruction sampling to be enabled!";
+            std::exit(EXIT_FAILURE);
+        }
+#ifndef HAVE_BPF
+        lo2s::Log::fatal() << "lo2s was built without BPF support, which --off-cpu requires";
+        std::exit(EXIT_FAILURE);
+#endif
+    }
 }
 
 void to_json(nlohmann::json& j, const perf::SamplingConfig& config)
@@ -110,9 +209,16 @@ void to_json(nlohmann::json& j, const perf::SamplingConfig& config)
     j = nlohmann::json({ { "enabled", config.enabled },
                          { "process_recording", config.process_recording },
                          { "period", config.period },
+                         { "adaptive_rate", config.adaptive_rate },
                          { "event", config.event },
+                         { "counters", config.counters },
                          { "exclude_kernel", config.exclude_kernel },
                          { "enable_callgraph", config.enable_callgraph },
-                         { "use_pebs", config.use_pebs } });
+                         { "dwarf_unwinding", config.dwarf_unwinding },
+                         { "unwind_stack_size", config.unwind_stack_size },
+                         { "memory_sampling", config.memory_sampling },
+                         { "use_pebs", config.use_pebs },
+                         { "off_cpu", config.off_cpu },
+                         { "off_cpu_threshold", config.off_cpu_threshold.count() } });
 }
 } // namespace lo2s::perf
@@ -12,6 +12,7 @@
 #include <nlohmann/json.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <string>
 #include <vector>
 
@@ -62,6 +63,37 @@ SyscallConfig::SyscallConfig(nitro::options::arguments& arguments)
 #endif
         }
     }
+
+    threshold = std::chrono::microseconds(arguments.as<uint64_t>("syscall-threshold"));
+    histograms = arguments.given("syscall-histograms");
+    histogram_interval =
+        std::chrono::milliseconds(arguments.as<uint64_t>("syscall-histogram-interval"));
+
+    if (histograms && threshold.count() != 0)
+    {
+        Log::fatal() << "--syscall-histograms and --syscall-threshold can not be combined";
+        std::exit(EXIT_FAILURE);
+    }
+    if (histograms && histogram_interval.count() == 0)
+    {
+        Log::fatal() << "--syscall-histogram-interval has to be greater than 0";
+        std::exit(EXIT_FAILURE);
+    }
+
+    if (bpf())
+    {
+        if (!enabled)
+        {
+            Log::fatal() << "--syscall-threshold and --syscall-histograms require selecting "
+                            "syscalls with --syscall";
+            std::exit(EXIT_FAILURE);
+        }
+#ifndef HAVE_BPF
+        Log::fatal() << "lo2s was built without BPF support, which --syscall-threshold and "
+                        "--syscall-histograms require";
+        std::exit(EXIT_FAILURE);
+#endif
+    }
 }
 
 void SyscallConfig::add_parser(nitro::options::parser& parser)
@@ -73,10 +105,28 @@ void SyscallConfig::add_parser(nitro::options::parser& parser)
         .short_name("s")
         .metavar("SYSCALL")
         .optional();
+    syscall_options
+        .option("syscall-threshold",
+                "Only record syscalls that took at least USEC microseconds, filtered in the "
+                "kernel with BPF. 0 records every syscall.")
+        .default_value("0")
+        .metavar("USEC");
+    syscall_options.toggle("syscall-histograms",
+                           "Instead of syscall events, periodically write the count, total time "
+                           "and a latency histogram per thread and syscall as metrics.");
+    syscall_options
+        .option("syscall-histogram-interval",
+                "Time in milliseconds between writing the syscall histograms.")
+        .default_value("1000")
+        .metavar("MSEC");
 }
 
 void to_json(nlohmann::json& j, const SyscallConfig& config)
 {
-    j = nlohmann::json({ { "enabled", config.enabled }, { "syscalls", config.syscalls } });
+    j = nlohmann::json({ { "enabled", config.enabled },
+                         { "syscalls", config.syscalls },
+                         { "threshold", config.threshold.count() },
+                         { "histograms", config.histograms },
+                         { "histogram_interval", config.histogram_interval.count() } });
 }
 } // namespace lo2s::perf
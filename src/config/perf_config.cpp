@@ -151,6 +151,18 @@ void Config::add_parser(nitro::options::parser& parser)
                 "Only record perf events for the given cgroup. Can only be used in system-mode")
         .metavar("NAME")
         .optional();
+    perf_options.toggle("no-numa-placement",
+                        "Do not place the buffers of a monitor thread on the NUMA node of the "
+                        "monitored CPU or thread.");
+    perf_options.toggle("metric-deltas",
+                        "Write counter metrics as the difference to the previous event instead "
+                        "of the accumulated value, leaving out events in which no counter changed.");
+    perf_options
+        .option("metric-delta-threshold",
+                "With --metric-deltas, also leave out events in which no counter changed by "
+                "more than N.")
+        .default_value("0")
+        .metavar("N");
     perf_options.toggle("list-events", "List available metric and sampling events.");
     perf_options.toggle("list-clockids", "List all available clockids.");
 
@@ -207,6 +219,26 @@ Config::Config(nitro::options::arguments& arguments)
         }
 
         mmap_pages = arguments.as<std::size_t>("mmap-pages");
+        if (mmap_pages == 0 || (mmap_pages & (mmap_pages - 1)) != 0)
+        {
+            Log::fatal() << "--mmap-pages has to be a power of two, as required by perf.";
+            std::exit(EXIT_FAILURE);
+        }
+
+        numa_placement = !arguments.given("no-numa-placement");
+
+        metric_deltas = arguments.given("metric-deltas");
+        metric_delta_threshold = arguments.as<double>("metric-delta-threshold");
+        if (metric_delta_threshold < 0)
+        {
+            Log::fatal() << "--metric-delta-threshold can not be negative.";
+            std::exit(EXIT_FAILURE);
+        }
+        if (arguments.provided("metric-delta-threshold") && !metric_deltas)
+        {
+            Log::fatal() << "--metric-delta-threshold can only be used with --metric-deltas.";
+            std::exit(EXIT_FAILURE);
+        }
     }
     catch (const lo2s::time::ClockProvider::InvalidClock& e)
     {
@@ -275,6 +307,8 @@ void to_json(nlohmann::json& j, const perf::Config& config)
                          { "use_tracepoints", config.any_tracepoints() },
                          { "syscall", config.syscall },
                          { "group", config.group },
+                         { "metric_deltas", config.metric_deltas },
+                         { "metric_delta_threshold", config.metric_delta_threshold },
                          { "userspace", config.userspace } });
 }
 } // namespace lo2s::perf
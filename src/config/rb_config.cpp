@@ -21,6 +21,7 @@ RingbufConfig::RingbufConfig(nitro::options::arguments& arguments)
     socket_path = arguments.get("socket");
     injectionlib_path = arguments.get("ld-library-path");
     size = arguments.as<uint64_t>("ringbuf-size");
+    huge_pages = arguments.given("ringbuf-huge-pages");
 
     read_interval = std::chrono::milliseconds(arguments.as<std::uint64_t>("ringbuf-read-interval"));
 }
@@ -44,6 +45,9 @@ void RingbufConfig::add_parser(nitro::options::parser& parser)
         .optional()
         .metavar("PAGES")
         .default_value("16");
+
+    rb_options.toggle("ringbuf-huge-pages",
+                      "Back the injection library ring-buffers with huge pages, if available.");
 }
 
 void to_json(nlohmann::json& j, const RingbufConfig& config)
@@ -51,6 +55,7 @@ void to_json(nlohmann::json& j, const RingbufConfig& config)
     j = nlohmann::json({ { "socket_path", config.socket_path },
                          { "injectionlib_path", config.injectionlib_path },
                          { "size", config.size },
+                         { "huge_pages", config.huge_pages },
                          { "read_interval", config.read_interval.count() } });
 }
 }; // namespace lo2s
@@ -4,11 +4,18 @@
 
 #include <lo2s/config/sensors_config.hpp>
 
+#include <lo2s/log.hpp>
+
 #include <nitro/options/arguments.hpp>
 #include <nitro/options/parser.hpp>
 #include <nlohmann/json.hpp>
 
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
 #include <cstdint>
+#include <cstdlib>
 
 namespace lo2s
 {
@@ -16,7 +23,32 @@ SensorsConfig::SensorsConfig(nitro::options::arguments& arguments)
 {
     enabled = arguments.given("sensors");
     read_interval =
-        std::chrono::milliseconds(arguments.as<std::uint64_t>("tracepoint-read-interval"));
+        std::chrono::milliseconds(arguments.as<std::uint64_t>("sensors-read-interval"));
+
+    for (const auto& sensor : arguments.get_all("sensor"))
+    {
+        auto pos = sensor.rfind('@');
+        if (pos == std::string::npos)
+        {
+            selection.push_back({ sensor, read_interval });
+            continue;
+        }
+
+        try
+        {
+            selection.push_back({ sensor.substr(0, pos),
+                                  std::chrono::milliseconds(std::stoull(sensor.substr(pos + 1))) });
+        }
+        catch (const std::logic_error&)
+        {
+            Log::fatal() << "Invalid sensor read interval in: " << sensor;
+            std::exit(EXIT_FAILURE);
+        }
+    }
+    if (!selection.empty())
+    {
+        enabled = true;
+    }
 }
 
 void SensorsConfig::add_parser(nitro::options::parser& parser)
@@ -27,6 +59,11 @@ void SensorsConfig::add_parser(nitro::options::parser& parser)
         .option("sensors-read-interval", "Time in milliseconds between readouts of sensors events")
         .default_value("100")
         .metavar("MSEC");
+    sensors_options
+        .multi_option("sensor", "Only record sensors whose name contains SENSOR, read every "
+                                "MSEC milliseconds if given (implies -S).")
+        .optional()
+        .metavar("SENSOR[@MSEC]");
 }
 
 void SensorsConfig::check()
@@ -43,6 +80,15 @@ void SensorsConfig::check()
 
 void to_json(nlohmann::json& j, const SensorsConfig& config)
 {
-    j = nlohmann::json({ { "enabled", config.enabled } });
+    auto selection = nlohmann::json::array();
+    for (const auto& sensor : config.selection)
+    {
+        selection.push_back({ { "pattern", sensor.pattern },
+                              { "read_interval", sensor.read_interval.count() } });
+    }
+
+    j = nlohmann::json({ { "enabled", config.enabled },
+                         { "read_interval", config.read_interval.count() },
+                         { "selection", selection } });
 }
 } // namespace lo2s
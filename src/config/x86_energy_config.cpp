@@ -5,22 +5,49 @@
 #include <lo2s/config/x86_energy_config.hpp>
 
 #include <lo2s/log.hpp>
+#include <lo2s/topology.hpp>
+#include <lo2s/types/cpu.hpp>
 
 #include <nitro/options/arguments.hpp>
 #include <nitro/options/parser.hpp>
 #include <nlohmann/json.hpp>
 
+#include <chrono>
+
+#include <cstdint>
+#include <cstdlib>
+
 namespace lo2s
 {
 X86EnergyConfig::X86EnergyConfig(nitro::options::arguments& arguments)
 {
     enabled = arguments.given("x86-energy");
+    read_interval =
+        std::chrono::milliseconds(arguments.as<std::uint64_t>("x86-energy-read-interval"));
+
+    if (arguments.provided("x86-energy-cpu"))
+    {
+        cpu = arguments.as<int>("x86-energy-cpu");
+    }
+    single_thread = arguments.given("x86-energy-single-thread") || cpu != -1;
 }
 
 void X86EnergyConfig::add_parser(nitro::options::parser& parser)
 {
     auto& x86_energy_options = parser.group("x86_energy options");
     x86_energy_options.toggle("x86-energy", "Add x86_energy recordings.").short_name("X");
+    x86_energy_options
+        .option("x86-energy-read-interval",
+                "Time in milliseconds between readouts of x86_energy counters")
+        .default_value("100")
+        .metavar("MSEC");
+    x86_energy_options.toggle("x86-energy-single-thread",
+                              "Read all x86_energy counters from a single thread.");
+    x86_energy_options
+        .option("x86-energy-cpu",
+                "Pin the single x86_energy thread to CPU (implies --x86-energy-single-thread).")
+        .optional()
+        .metavar("CPU");
 }
 
 void X86EnergyConfig::check() const
@@ -33,11 +60,25 @@ void X86EnergyConfig::check() const
         std::exit(EXIT_FAILURE);
     }
 #endif
+    if (enabled && read_interval.count() == 0)
+    {
+        // A timerfd with a zero interval is disarmed, so nothing would ever be read
+        lo2s::Log::fatal() << "--x86-energy-read-interval must be at least 1 ms";
+        std::exit(EXIT_FAILURE);
+    }
+    if (cpu != -1 && !Topology::instance().cpus().count(Cpu(cpu)))
+    {
+        lo2s::Log::fatal() << "Cannot pin x86_energy thread to unknown cpu " << cpu;
+        std::exit(EXIT_FAILURE);
+    }
 }
 
 void to_json(nlohmann::json& j, const X86EnergyConfig& config)
 {
-    j = nlohmann::json({ { "enabled", config.enabled } });
+    j = nlohmann::json({ { "enabled", config.enabled },
+                         { "single_thread", config.single_thread },
+                         { "cpu", config.cpu },
+                         { "read_interval", config.read_interval.count() } });
 }
 
 } // namespace lo2s
@@ -2,12 +2,12 @@
 //
 // SPDX-License-Identifier: GPL-3.0-or-later
 
+#include <lo2s/gpu/buffer_pool.hpp>
 #include <lo2s/gpu/ringbuf.hpp>
 #include <lo2s/types/process.hpp>
 
 #include <iostream>
 #include <memory>
-#include <string>
 
 #include <cassert>
 #include <cstddef>
@@ -21,12 +21,25 @@
 #include <cupti_driver_cbid.h>
 #include <cupti_result.h>
 #include <cupti_runtime_cbid.h>
-// Allocate 8 MiB every time CUPTI asks for more event memory
+// Defaults if lo2s did not pass the buffer configuration in the environment
 constexpr size_t CUPTI_BUFFER_SIZE = static_cast<const size_t>(8 * 1024 * 1024);
+constexpr size_t CUPTI_BUFFER_COUNT = 4;
 
 namespace
 {
 
+lo2s::gpu::BufferPool buffer_pool(CUPTI_BUFFER_SIZE, CUPTI_BUFFER_COUNT);
+
+size_t env_or_default(const char* name, size_t default_value)
+{
+    const char* value = getenv(name);
+    if (value == nullptr)
+    {
+        return default_value;
+    }
+    return std::strtoull(value, nullptr, 10);
+}
+
 std::unique_ptr<lo2s::gpu::RingbufWriter> rb_writer = nullptr;
 
 CUpti_SubscriberHandle subscriber = nullptr;
@@ -43,8 +56,8 @@ void CUPTIAPI bufferRequested(uint8_t** buffer, size_t* size, size_t* maxNumReco
     assert(buffer != nullptr && size != nullptr && maxNumRecords != nullptr);
 
     *maxNumRecords = 0;
-    *size = CUPTI_BUFFER_SIZE;
-    *buffer = static_cast<uint8_t*>(malloc(*size));
+    *size = buffer_pool.buffer_size();
+    *buffer = buffer_pool.get();
 
     if (*buffer == nullptr)
     {
@@ -71,9 +84,7 @@ void CUPTIAPI bufferCompleted(CUcontext ctx, uint32_t streamId, uint8_t* buffer,
         {
             auto const* kernel = reinterpret_cast<CUpti_ActivityKernel6*>(record);
 
-            std::string const kernel_name = kernel->name;
-            uint64_t cctx = 0;
-            cctx = rb_writer->kernel_def(kernel_name);
+            uint64_t const cctx = rb_writer->kernel_def(kernel->name);
 
             rb_writer->kernel(kernel->start, kernel->end, cctx);
             break;
@@ -98,7 +109,7 @@ void CUPTIAPI bufferCompleted(CUcontext ctx, uint32_t streamId, uint8_t* buffer,
                   << std::endl;
     }
 
-    free(buffer);
+    buffer_pool.put(buffer);
 }
 
 // callbackHandler is our universal callback handler for the callback based part of the CUPTI
@@ -157,6 +168,9 @@ extern "C" int InitializeInjection(void)
 {
     rb_writer = std::make_unique<lo2s::gpu::RingbufWriter>(lo2s::Process::me());
 
+    buffer_pool.configure(env_or_default("LO2S_CUPTI_BUFFER_SIZE", CUPTI_BUFFER_SIZE),
+                          env_or_default("LO2S_CUPTI_BUFFER_COUNT", CUPTI_BUFFER_COUNT));
+
     // Register an atexit() handler for clean-up
     if (atexit(&atExitHandler) != 0)
     {
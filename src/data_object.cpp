@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <lo2s/data_object.hpp>
+
+#include <lo2s/address.hpp>
+#include <lo2s/dwfl_session.hpp>
+#include <lo2s/memory_map.hpp>
+#include <lo2s/types/process.hpp>
+#include <lo2s/util.hpp>
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <cstdint>
+
+extern "C"
+{
+#include <elfutils/libdwfl.h>
+#include <gelf.h>
+}
+
+namespace lo2s
+{
+namespace
+{
+bool is_anonymous(const std::string& filename)
+{
+    // perf reports anonymous mappings as "//anon", /proc/[pid]/maps leaves the name empty
+    return filename.empty() || filename == "//anon" || filename == "/anon_hugepage";
+}
+
+bool is_kernel_address(uint64_t addr)
+{
+    // The upper half of the address space belongs to the kernel on all supported architectures
+    return (addr >> 63) != 0;
+}
+} // namespace
+
+DataObjectResolver::ProcessState& DataObjectResolver::process_state(Process process)
+{
+    const std::lock_guard<std::mutex> lock(mutex_);
+    // Elements of a std::map stay where they are, so the state can be used after unlocking
+    auto [it, inserted] = processes_.try_emplace(process);
+    if (inserted)
+    {
+        auto& state = it->second;
+        add_existing_mappings(process, [&state](uint64_t start, uint64_t end, uint64_t pgoff,
+                                                const std::string& filename) {
+            add_mapping(state, start, end, pgoff, filename);
+        });
+    }
+    return it->second;
+}
+
+void DataObjectResolver::add_mapping(Process process, uint64_t start, uint64_t end, uint64_t pgoff,
+                                     const std::string& filename)
+{
+    auto& state = process_state(process);
+    const std::lock_guard<std::mutex> lock(state.mutex);
+    add_mapping(state, start, end, pgoff, filename);
+}
+
+void DataObjectResolver::add_mapping(ProcessState& state, uint64_t start, uint64_t end,
+                                     uint64_t pgoff, const std::string& filename)
+{
+    state.mappings.emplace(Mapping(start, end, pgoff), std::make_shared<DataMapping>(filename));
+    if (pgoff == 0 && !known_non_executable(filename))
+    {
+        state.bases[filename] = start;
+    }
+}
+
+Dwfl_Module* DataObjectResolver::module_for(ProcessState& state, const std::string& filename)
+{
+    auto base = state.bases.find(filename);
+    if (base == state.bases.end())
+    {
+        return nullptr;
+    }
+    return state.session.report(filename, base->second);
+}
+
+std::string DataObjectResolver::lookup(Process process, uint64_t addr)
+{
+    // Events that do not record a data address, such as cpu-clock, report 0
+    if (addr == 0)
+    {
+        return "[unknown]";
+    }
+    if (is_kernel_address(addr))
+    {
+        return "[kernel]";
+    }
+
+    auto& state = process_state(process);
+    const std::lock_guard<std::mutex> lock(state.mutex);
+
+    auto it = state.mappings.find(addr);
+    if (it == state.mappings.end())
+    {
+        return "[unknown]";
+    }
+
+    const std::string filename = it->second->name();
+    if (is_anonymous(filename))
+    {
+        return "[anon]";
+    }
+    // [heap], [stack], [vdso], ...
+    if (known_non_executable(filename))
+    {
+        return filename;
+    }
+
+    Dwfl_Module* mod = module_for(state, filename);
+    if (mod != nullptr)
+    {
+        GElf_Off offset = 0;
+        GElf_Sym sym;
+        const char* name =
+            dwfl_module_addrinfo(mod, addr, &offset, &sym, nullptr, nullptr, nullptr);
+        // Only global variables, not functions whose code is read as data
+        if (name != nullptr && GELF_ST_TYPE(sym.st_info) == STT_OBJECT && offset < sym.st_size)
+        {
+            return name;
+        }
+    }
+    return filename;
+}
+} // namespace lo2s
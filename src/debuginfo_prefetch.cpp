@@ -0,0 +1,245 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <lo2s/debuginfo_prefetch.hpp>
+
+#include <lo2s/config.hpp>
+#include <lo2s/config/dwarf_config.hpp>
+#include <lo2s/log.hpp>
+
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+extern "C"
+{
+#include <elfutils/libdwelf.h>
+#include <fcntl.h>
+#include <libelf.h>
+#include <unistd.h>
+
+#ifdef HAVE_DEBUGINFOD
+#include <elfutils/debuginfod.h>
+#endif
+}
+
+namespace lo2s
+{
+#ifdef HAVE_DEBUGINFOD
+namespace
+{
+// Returns an empty build-id if the binary has none or can not be read
+std::vector<unsigned char> read_build_id(const std::string& binary)
+{
+    std::vector<unsigned char> res;
+
+    int const fd = open(binary.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        return res;
+    }
+
+    elf_version(EV_CURRENT);
+    Elf* elf = elf_begin(fd, ELF_C_READ_MMAP, nullptr);
+    if (elf != nullptr)
+    {
+        const void* build_id = nullptr;
+        ssize_t const len = dwelf_elf_gnu_build_id(elf, &build_id);
+        if (len > 0)
+        {
+            const auto* bits = static_cast<const unsigned char*>(build_id);
+            res.assign(bits, bits + len);
+        }
+        elf_end(elf);
+    }
+    close(fd);
+    return res;
+}
+
+// Debug information that is installed locally is found without debuginfod
+bool has_local_debuginfo(const std::string& key)
+{
+    std::error_code ec;
+    return std::filesystem::exists(std::filesystem::path("/usr/lib/debug/.build-id") /
+                                       key.substr(0, 2) / (key.substr(2) + ".debug"),
+                                   ec);
+}
+} // namespace
+#endif
+
+DebuginfoPrefetcher::~DebuginfoPrefetcher()
+{
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+        for (const auto& request : requests_)
+        {
+            debuginfos_[request.key].state = State::MISSING;
+        }
+        requests_.clear();
+    }
+    requested_.notify_all();
+    finished_.notify_all();
+
+    for (auto& worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+std::string DebuginfoPrefetcher::build_id_string(const unsigned char* bits, std::size_t len)
+{
+    static const char* digits = "0123456789abcdef";
+
+    std::string res;
+    res.reserve(2 * len);
+    for (std::size_t i = 0; i < len; i++)
+    {
+        res += digits[bits[i] >> 4];
+        res += digits[bits[i] & 0xf];
+    }
+    return res;
+}
+
+void DebuginfoPrefetcher::prefetch([[maybe_unused]] const std::vector<std::string>& binaries)
+{
+#ifdef HAVE_DEBUGINFOD
+    if (config().dwarf.usage != DwarfUsage::FULL)
+    {
+        return;
+    }
+
+    const std::lock_guard<std::mutex> lock(mutex_);
+
+    std::size_t num_requests = 0;
+    for (const auto& binary : binaries)
+    {
+        auto build_id = read_build_id(binary);
+        if (build_id.empty())
+        {
+            continue;
+        }
+
+        auto key = build_id_string(build_id.data(), build_id.size());
+        if (has_local_debuginfo(key))
+        {
+            continue;
+        }
+
+        // Already requested, or known to be missing. Requests that failed for other reasons
+        // than the servers not having the debug information are tried again.
+        auto [it, inserted] = debuginfos_.try_emplace(key, Debuginfo{ State::PENDING, "" });
+        if (!inserted)
+        {
+            if (it->second.state != State::UNKNOWN)
+            {
+                continue;
+            }
+            it->second.state = State::PENDING;
+        }
+
+        requests_.push_back({ binary, std::move(build_id), std::move(key) });
+        num_requests++;
+    }
+
+    if (num_requests == 0)
+    {
+        return;
+    }
+
+    Log::info() << "Downloading debug information for " << num_requests << " binaries, "
+                << config().dwarf.debuginfod_jobs << " at a time";
+
+    // The workers wait for further requests instead of exiting, so they are only started once
+    while (workers_.size() < config().dwarf.debuginfod_jobs && workers_.size() < requests_.size())
+    {
+        workers_.emplace_back([this]() { work(); });
+    }
+    requested_.notify_all();
+#endif
+}
+
+DebuginfoPrefetcher::Debuginfo DebuginfoPrefetcher::wait_for(const std::string& build_id)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    auto it = debuginfos_.find(build_id);
+    if (it == debuginfos_.end())
+    {
+        return {};
+    }
+
+    finished_.wait(lock, [&it]() { return it->second.state != State::PENDING; });
+    return it->second;
+}
+
+void DebuginfoPrefetcher::work()
+{
+#ifdef HAVE_DEBUGINFOD
+    // debuginfod clients must not be shared between threads
+    debuginfod_client* client = debuginfod_begin();
+
+    while (true)
+    {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            requested_.wait(lock, [this]() { return stop_ || !requests_.empty(); });
+            if (stop_)
+            {
+                break;
+            }
+            request = std::move(requests_.front());
+            requests_.pop_front();
+        }
+
+        // Falls back to the normal lookup in the DwarfFunctionResolver
+        Debuginfo result{ State::UNKNOWN, "" };
+        if (client != nullptr)
+        {
+            char* path = nullptr;
+            int const fd = debuginfod_find_debuginfo(client, request.build_id.data(),
+                                                     static_cast<int>(request.build_id.size()),
+                                                     &path);
+            if (fd >= 0)
+            {
+                result = { State::FOUND, path };
+                close(fd);
+                free(path); // NOLINT
+            }
+            else if (fd == -ENOENT)
+            {
+                // Only remember that the servers do not have it, timeouts or connection errors
+                // might not happen again
+                result.state = State::MISSING;
+                Log::debug() << "No debug information for " << request.binary;
+            }
+            else
+            {
+                Log::debug() << "Can not download debug information for " << request.binary
+                             << ": " << strerror(-fd);
+            }
+        }
+
+        {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            debuginfos_[request.key] = result;
+        }
+        finished_.notify_all();
+    }
+
+    if (client != nullptr)
+    {
+        debuginfod_end(client);
+    }
+#endif
+}
+} // namespace lo2s
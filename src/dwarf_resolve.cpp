@@ -7,6 +7,7 @@
 #include <lo2s/address.hpp>
 #include <lo2s/config.hpp>
 #include <lo2s/config/dwarf_config.hpp>
+#include <lo2s/debuginfo_prefetch.hpp>
 #include <lo2s/function_resolver.hpp>
 #include <lo2s/indicator.hpp>
 #include <lo2s/line_info.hpp>
@@ -18,8 +19,11 @@
 #include <stdexcept>
 #include <string>
 
+#include <cstring>
+
 #include <elfutils/libdw.h>
 #include <elfutils/libdwfl.h>
+#include <fcntl.h>
 #include <gelf.h>
 #include <unistd.h>
 
@@ -91,12 +95,42 @@ int progress_fn([[maybe_unused]] debuginfod_client* c, long a, long b)
  * an object file. In our case, this is simply a wrapper around the standard
  * dwfl_standard_find_debuginfo function, which records some additional information to be used in th
  * progress_fn() callback.
+ *
+ * Debug information that is prefetched by the DebuginfoPrefetcher is taken from there instead.
  */
 int standard_find_debuginfo_wrapper(Dwfl_Module* mod, void** userdata, const char* modname,
                                     Dwarf_Addr base, const char* file_name,
                                     const char* debuglink_file, GElf_Word debuglink_crc,
                                     char** debuginfo_file_name)
 {
+#ifdef HAVE_DEBUGINFOD
+    const unsigned char* bits = nullptr;
+    GElf_Addr vaddr = 0;
+    int const len = dwfl_module_build_id(mod, &bits, &vaddr);
+    if (len > 0)
+    {
+        auto debuginfo = DebuginfoPrefetcher::instance().wait_for(
+            DebuginfoPrefetcher::build_id_string(bits, len));
+
+        if (debuginfo.state == DebuginfoPrefetcher::State::FOUND)
+        {
+            int const fd = open(debuginfo.path.c_str(), O_RDONLY);
+            if (fd != -1)
+            {
+                *debuginfo_file_name = strdup(debuginfo.path.c_str());
+                return fd;
+            }
+        }
+        else if (debuginfo.state == DebuginfoPrefetcher::State::MISSING)
+        {
+            // The servers do not have it, do not ask them again and only look for local files
+            return dwfl_build_id_find_debuginfo(mod, userdata, modname, base, file_name,
+                                                debuglink_file, debuglink_crc,
+                                                debuginfo_file_name);
+        }
+    }
+#endif
+
     if (logging::get_min_severity_level() <= nitro::log::severity_level::info &&
         isatty(STDERR_FILENO))
     {
@@ -0,0 +1,290 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <lo2s/dwarf_unwind.hpp>
+
+#include <lo2s/dwfl_session.hpp>
+#include <lo2s/log.hpp>
+#include <lo2s/types/process.hpp>
+#include <lo2s/types/thread.hpp>
+#include <lo2s/util.hpp>
+
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+extern "C"
+{
+#include <elfutils/libdwfl.h>
+
+#if defined(__x86_64__)
+#include <asm/perf_regs.h>
+#endif
+}
+
+namespace lo2s
+{
+namespace
+{
+#if defined(__x86_64__)
+// The general purpose registers, in the order of the DWARF register numbers of x86_64
+constexpr int dwarf_regs[] = { PERF_REG_X86_AX, PERF_REG_X86_DX, PERF_REG_X86_CX, PERF_REG_X86_BX,
+                               PERF_REG_X86_SI, PERF_REG_X86_DI, PERF_REG_X86_BP, PERF_REG_X86_SP,
+                               PERF_REG_X86_R8, PERF_REG_X86_R9, PERF_REG_X86_R10,
+                               PERF_REG_X86_R11, PERF_REG_X86_R12, PERF_REG_X86_R13,
+                               PERF_REG_X86_R14, PERF_REG_X86_R15 };
+constexpr int pc_reg = PERF_REG_X86_IP;
+constexpr int sp_reg = PERF_REG_X86_SP;
+#else
+constexpr int dwarf_regs[] = { 0 };
+constexpr int pc_reg = 0;
+constexpr int sp_reg = 0;
+#endif
+
+constexpr std::size_t num_dwarf_regs = std::size(dwarf_regs);
+
+// The registers of a sample only contain the registers of sample_regs_user(), ordered by their
+// perf register number, so the index of a register is the number of recorded registers below it
+std::size_t sample_reg_index(int reg)
+{
+    return __builtin_popcountll(DwarfUnwinder::sample_regs_user() & ((1ULL << reg) - 1));
+}
+} // namespace
+
+const Dwfl_Thread_Callbacks DwarfUnwinder::thread_callbacks_ = {
+    DwarfUnwinder::next_thread,           // next_thread
+    nullptr,                              // get_thread
+    DwarfUnwinder::memory_read,           // memory_read
+    DwarfUnwinder::set_initial_registers, // set_initial_registers
+    nullptr,                              // detach
+    nullptr,                              // thread_detach
+};
+
+uint64_t DwarfUnwinder::sample_regs_user()
+{
+    if (!supported())
+    {
+        return 0;
+    }
+
+    uint64_t mask = 1ULL << pc_reg;
+    for (auto reg : dwarf_regs)
+    {
+        mask |= 1ULL << reg;
+    }
+    return mask;
+}
+
+bool DwarfUnwinder::supported()
+{
+#if defined(__x86_64__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+DwarfUnwinder::ProcessState& DwarfUnwinder::process_state(Process process)
+{
+    const std::lock_guard<std::mutex> lock(mutex_);
+    // Elements of a std::map stay where they are, so the state can be used after unlocking
+    auto [it, inserted] = processes_.try_emplace(process, process);
+    if (inserted)
+    {
+        auto& state = it->second;
+        add_existing_mappings(process, [&state](uint64_t start, uint64_t end, uint64_t pgoff,
+                                                const std::string& filename) {
+            if (!known_non_executable(filename))
+            {
+                add_mapping(state, start, end, pgoff, filename);
+            }
+        });
+    }
+    return it->second;
+}
+
+void DwarfUnwinder::add_mapping(Process process, uint64_t start, uint64_t end, uint64_t pgoff,
+                                const std::string& filename)
+{
+    auto& state = process_state(process);
+    const std::lock_guard<std::mutex> lock(state.mutex);
+    add_mapping(state, start, end, pgoff, filename);
+}
+
+void DwarfUnwinder::add_mapping(ProcessState& state, uint64_t start, uint64_t end, uint64_t pgoff,
+                                const std::string& filename)
+{
+    // A new mapping over an old one, e.g. after exec()
+    auto it = state.mappings.lower_bound(start);
+    if (it != state.mappings.begin() && std::prev(it)->second.end > start)
+    {
+        it = std::prev(it);
+    }
+
+    bool reported = false;
+    while (it != state.mappings.end() && it->first < end)
+    {
+        reported |= state.session.tried(it->second.filename, it->first - it->second.pgoff);
+        it = state.mappings.erase(it);
+    }
+
+    if (reported)
+    {
+        state.session.reset();
+        state.attached = false;
+    }
+
+    state.mappings.emplace(start, Mapping{ end, pgoff, filename });
+}
+
+void DwarfUnwinder::report_module(ProcessState& state, uint64_t addr)
+{
+    if (dwfl_addrmodule(state.session.get(), addr) != nullptr)
+    {
+        return;
+    }
+
+    auto it = state.mappings.upper_bound(addr);
+    if (it == state.mappings.begin())
+    {
+        return;
+    }
+    it = std::prev(it);
+
+    if (addr < it->second.end)
+    {
+        state.session.report(it->second.filename, it->first - it->second.pgoff);
+    }
+}
+
+bool DwarfUnwinder::prepare(ProcessState& state, uint64_t ip)
+{
+    if (state.session.get() == nullptr)
+    {
+        return false;
+    }
+
+    report_module(state, ip);
+
+    if (!state.attached)
+    {
+        // The architecture is taken from the first reported module, so there has to be one
+        if (dwfl_addrmodule(state.session.get(), ip) == nullptr)
+        {
+            return false;
+        }
+
+        if (!dwfl_attach_state(state.session.get(), nullptr, state.process.as_int(),
+                               &thread_callbacks_, &state))
+        {
+            Log::debug() << "Could not attach unwinding state for " << state.process << ": "
+                         << dwfl_errmsg(-1);
+            return false;
+        }
+        state.attached = true;
+    }
+    return true;
+}
+
+void DwarfUnwinder::unwind(Process process, Thread thread, const uint64_t regs[],
+                           const char* stack, uint64_t stack_size, std::vector<uint64_t>& ips)
+{
+    auto& state = process_state(process);
+    const std::lock_guard<std::mutex> lock(state.mutex);
+
+    if (!prepare(state, regs[sample_reg_index(pc_reg)]))
+    {
+        // Without any known mapping, the best we can do is the leaf
+        ips.emplace_back(regs[sample_reg_index(pc_reg)]);
+        return;
+    }
+
+    state.current.thread = thread;
+    state.current.regs = regs;
+    state.current.stack = stack;
+    state.current.stack_size = stack_size;
+    state.current.ips = &ips;
+
+    auto num_ips = ips.size();
+
+    // Returns an error once the unwinding runs into a frame without CFI, which is the usual end
+    dwfl_getthread_frames(state.session.get(), thread.as_int(), frame_callback, &state);
+
+    if (ips.size() == num_ips)
+    {
+        ips.emplace_back(regs[sample_reg_index(pc_reg)]);
+    }
+}
+
+pid_t DwarfUnwinder::next_thread(Dwfl* /*unused*/, void* arg, void** thread_argp)
+{
+    // The only thread of the session is the one of the current sample
+    if (*thread_argp != nullptr)
+    {
+        return 0;
+    }
+    *thread_argp = arg;
+    return static_cast<ProcessState*>(arg)->current.thread.as_int();
+}
+
+bool DwarfUnwinder::memory_read(Dwfl* /*unused*/, Dwarf_Addr addr, Dwarf_Word* result, void* arg)
+{
+    const auto& current = static_cast<ProcessState*>(arg)->current;
+    const uint64_t sp = current.regs[sample_reg_index(sp_reg)];
+
+    // Only the stack snapshot of the sample is available
+    if (addr < sp || addr + sizeof(Dwarf_Word) > sp + current.stack_size)
+    {
+        return false;
+    }
+
+    std::memcpy(result, current.stack + (addr - sp), sizeof(Dwarf_Word));
+    return true;
+}
+
+bool DwarfUnwinder::set_initial_registers(Dwfl_Thread* thread, void* arg)
+{
+    const auto& current = static_cast<ProcessState*>(arg)->current;
+
+    Dwarf_Word regs[num_dwarf_regs];
+    for (std::size_t i = 0; i < num_dwarf_regs; i++)
+    {
+        regs[i] = current.regs[sample_reg_index(dwarf_regs[i])];
+    }
+
+    if (!dwfl_thread_state_registers(thread, 0, num_dwarf_regs, regs))
+    {
+        return false;
+    }
+    dwfl_thread_state_register_pc(thread, current.regs[sample_reg_index(pc_reg)]);
+    return true;
+}
+
+int DwarfUnwinder::frame_callback(Dwfl_Frame* frame, void* arg)
+{
+    auto& state = *static_cast<ProcessState*>(arg);
+    auto& current = state.current;
+
+    Dwarf_Addr pc = 0;
+    if (!dwfl_frame_pc(frame, &pc, nullptr))
+    {
+        return DWARF_CB_ABORT;
+    }
+
+    current.ips->emplace_back(pc);
+    if (current.ips->size() >= MAX_FRAMES)
+    {
+        return DWARF_CB_ABORT;
+    }
+
+    // The next frame is unwound with the CFI of the module this one lies in
+    report_module(state, pc);
+    return DWARF_CB_OK;
+}
+} // namespace lo2s
@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <lo2s/dwfl_session.hpp>
+
+#include <lo2s/log.hpp>
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <cstdint>
+
+extern "C"
+{
+#include <elfutils/libdwfl.h>
+}
+
+namespace lo2s
+{
+namespace
+{
+int no_find_debuginfo(Dwfl_Module* /*unused*/, void** /*unused*/, const char* /*unused*/,
+                      GElf_Addr /*unused*/, const char* /*unused*/, const char* /*unused*/,
+                      GElf_Word /*unused*/, char** /*unused*/)
+{
+    return -1;
+}
+
+const Dwfl_Callbacks dwfl_callbacks = {
+    dwfl_build_id_find_elf,       // find_elf
+    no_find_debuginfo,            // find_debuginfo
+    dwfl_offline_section_address, // section_address
+    nullptr,                      // debuginfo_path
+};
+} // namespace
+
+Dwfl* DwflSession::get()
+{
+    if (!dwfl_)
+    {
+        dwfl_ = std::unique_ptr<Dwfl, DwflDeleter>(dwfl_begin(&dwfl_callbacks));
+        if (!dwfl_)
+        {
+            Log::warn() << "Could not open dwfl session for " << purpose_ << ": "
+                        << dwfl_errmsg(-1);
+        }
+    }
+    return dwfl_.get();
+}
+
+Dwfl_Module* DwflSession::report(const std::string& filename, uint64_t base)
+{
+    auto it = modules_.find(std::make_pair(filename, base));
+    if (it != modules_.end())
+    {
+        return it->second;
+    }
+
+    auto& mod = modules_[std::make_pair(filename, base)];
+
+    Dwfl* dwfl = get();
+    if (dwfl == nullptr)
+    {
+        return nullptr;
+    }
+
+    dwfl_report_begin_add(dwfl);
+    mod = dwfl_report_elf(dwfl, filename.c_str(), filename.c_str(), -1, base, false);
+    dwfl_report_end(dwfl, nullptr, nullptr);
+
+    if (mod == nullptr)
+    {
+        Log::debug() << "Can not use " << filename << " for " << purpose_ << ": "
+                     << dwfl_errmsg(-1);
+    }
+    return mod;
+}
+} // namespace lo2s
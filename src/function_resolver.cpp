@@ -10,19 +10,16 @@
 
 #include <exception>
 #include <memory>
+#include <mutex>
 #include <string>
 
 namespace lo2s
 {
-
-std::shared_ptr<FunctionResolver> function_resolver_for(const std::string& filename)
+namespace
+{
+std::shared_ptr<FunctionResolver> load_function_resolver(const std::string& filename)
 {
     std::shared_ptr<FunctionResolver> fr;
-    if (known_non_executable(filename))
-    {
-        return nullptr;
-    }
-
     try
     {
         fr = DwarfFunctionResolver::cache(filename);
@@ -35,4 +32,21 @@ std::shared_ptr<FunctionResolver> function_resolver_for(const std::string& filen
 
     return fr;
 }
+} // namespace
+
+LineInfo LazyFunctionResolver::lookup_line_info(Address addr)
+{
+    std::call_once(loaded_, [this]() { resolver_ = load_function_resolver(name_); });
+    return resolver_->lookup_line_info(addr);
+}
+
+std::shared_ptr<FunctionResolver> function_resolver_for(const std::string& filename)
+{
+    if (known_non_executable(filename))
+    {
+        return nullptr;
+    }
+
+    return LazyFunctionResolver::cache(filename);
+}
 } // namespace lo2s
@@ -5,7 +5,10 @@
 #include <lo2s/local_cctx_tree.hpp>
 
 #include <lo2s/calling_context.hpp>
+#include <lo2s/log.hpp>
 #include <lo2s/measurement_scope.hpp>
+#include <lo2s/stream/format.hpp>
+#include <lo2s/stream/stream.hpp>
 #include <lo2s/trace/trace.hpp>
 
 #include <otf2xx/chrono/time_point.hpp>
@@ -18,37 +21,59 @@ namespace lo2s
 {
 LocalCctxTree::LocalCctxTree(trace::Trace& trace, MeasurementScope scope)
 : tree(CallingContext::root(), LocalCctxNode(0)), trace_(trace),
-  writer_(trace_.sample_writer(scope)), cur_({ &tree })
+  writer_(trace_.sample_writer(scope)),
+  stream_(trace_.stream(), stream::SourceType::CCTX_TREE, scope.name()), cur_({ &tree })
 {
 }
 
-void LocalCctxTree::cctx_sample(otf2::chrono::time_point& tp, uint64_t num_ips,
-                                const uint64_t ips[])
+void LocalCctxTree::finalize()
 {
-    auto* node = cur_.back();
+    ref_count_ = next_cctx_ref_;
+    stream_.flush();
 
-    for (uint64_t i = num_ips - 1; i != 0; i--)
+    if (callchain_cache_.hits() + callchain_cache_.misses() != 0)
     {
-        if (ips[i] == PERF_CONTEXT_KERNEL || ips[i] == PERF_CONTEXT_USER)
+        Log::debug() << "Callchain cache: " << callchain_cache_.hits() << " hits, "
+                     << callchain_cache_.misses() << " misses";
+    }
+}
+
+LocalCctxNode& LocalCctxTree::cctx_sample(otf2::chrono::time_point& tp, uint64_t num_ips,
+                                          const uint64_t ips[])
+{
+    auto* parent = cur_.back();
+    auto* node = callchain_cache_.find(parent, num_ips, ips);
+    if (node == nullptr)
+    {
+        node = parent;
+        for (uint64_t i = num_ips - 1; i != 0; i--)
         {
-            if (i <= 1)
+            if (ips[i] == PERF_CONTEXT_KERNEL || ips[i] == PERF_CONTEXT_USER)
             {
-                break;
+                if (i <= 1)
+                {
+                    break;
+                }
+                continue;
             }
-            continue;
+            node = create_cctx_node(CallingContext::sample(ips[i]), node);
         }
-        node = create_cctx_node(CallingContext::sample(ips[i]), node);
+        callchain_cache_.insert(parent, num_ips, ips, node);
     }
 
     writer_.write_calling_context_sample(tp, node->second.ref, num_ips,
                                          trace_.interrupt_generator().ref());
+    stream_.cctx_sample(tp, node->second.ref);
+    return node->second;
 }
 
-void LocalCctxTree::cctx_sample(otf2::chrono::time_point tp, uint64_t ip)
+LocalCctxNode& LocalCctxTree::cctx_sample(otf2::chrono::time_point tp, uint64_t ip)
 {
     auto* node = create_cctx_node(CallingContext::sample(ip), cur_.back());
     writer_.write_calling_context_sample(tp, node->second.ref, 2,
                                          trace_.interrupt_generator().ref());
+    stream_.cctx_sample(tp, node->second.ref);
+    return node->second;
 }
 
 } // namespace lo2s
@@ -33,7 +33,10 @@ int main(int argc, const char** argv)
         switch (lo2s::config().general.monitor_type)
         {
         case lo2s::MonitorType::CPU_SET:
-            lo2s::monitor::CpuSetMonitor().run();
+            // Every iteration records into a new trace, see --rotate-interval
+            while (lo2s::monitor::CpuSetMonitor().run())
+            {
+            }
             break;
         case lo2s::MonitorType::PROCESS:
             lo2s::monitor::ProcessMonitor monitor;
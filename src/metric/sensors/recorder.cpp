@@ -18,20 +18,28 @@
 #include <otf2xx/definition/detail/weak_ref.hpp>
 #include <otf2xx/event/metric.hpp>
 
+#include <chrono>
+#include <map>
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <cassert>
+#include <cerrno>
+#include <cmath>
 #include <cstdint>
+#include <cstdlib>
 
 #include <fmt/format.h>
 #include <unistd.h>
 
 extern "C"
 {
+#include <fcntl.h>
 #include <math.h>
 #include <sensors/sensors.h>
 #include <string.h>
@@ -83,17 +91,102 @@ std::string chip_name_to_str(const sensors_chip_name* chip)
 
     return chip_name;
 }
+
+// Scaling applied by libsensors to the raw hwmon values, see get_type_scaling() in libsensors
+double get_scale(const sensors_feature* feature)
+{
+    switch (feature->type)
+    {
+    case SENSORS_FEATURE_IN:
+    case SENSORS_FEATURE_TEMP:
+    case SENSORS_FEATURE_CURR:
+    case SENSORS_FEATURE_HUMIDITY:
+    case SENSORS_FEATURE_VID:
+        return 1000;
+    case SENSORS_FEATURE_POWER:
+    case SENSORS_FEATURE_ENERGY:
+        return 1000000;
+    default:
+        return 1;
+    }
+}
+
+bool read_raw(int fd, double& value)
+{
+    char buf[32];
+    auto len = ::pread(fd, buf, sizeof(buf) - 1, 0);
+    if (len <= 0)
+    {
+        return false;
+    }
+    buf[len] = '\0';
+
+    char* end = nullptr;
+    value = std::strtod(buf, &end);
+    return end != buf;
+}
+
+// Opens the hwmon file backing the sub feature, so that it can be re-read with pread() instead of
+// going through libsensors every time. Returns -1 if the value of the file does not match the one
+// reported by libsensors, e.g. because of compute statements in sensors.conf.
+int open_hwmon_file(const sensors_chip_name* chip, const sensors_subfeature* sub_feature,
+                    double scale, double expected)
+{
+    auto path = fmt::format("{}/{}", chip->path, sub_feature->name);
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        Log::debug() << "Reading " << path << " through libsensors";
+        return -1;
+    }
+
+    double raw = NAN;
+    if (!read_raw(fd, raw) || std::abs(raw / scale - expected) > 0.05 * std::abs(expected) + 0.01)
+    {
+        Log::debug() << "Reading " << path << " through libsensors";
+        ::close(fd);
+        return -1;
+    }
+    Log::debug() << "Reading " << path << " with pread()";
+    return fd;
+}
+
+// Returns the read interval of the given sensor, or nothing if it was not selected by the user
+std::optional<std::chrono::milliseconds> read_interval_for(const std::string& sensor_name)
+{
+    const auto& selection = config().sensors.selection;
+    if (selection.empty())
+    {
+        return config().sensors.read_interval;
+    }
+
+    for (const auto& sensor : selection)
+    {
+        if (sensor_name.find(sensor.pattern) != std::string::npos)
+        {
+            return sensor.read_interval;
+        }
+    }
+    return std::nullopt;
+}
 } // namespace
 
 Recorder::Recorder(trace::Trace& trace)
-: PollMonitor(trace, "Sensors recorder"), otf2_writer_(trace.create_metric_writer(name())),
-  metric_instance_(trace.metric_instance(trace.metric_class(), otf2_writer_.location(),
-                                         trace.system_tree_root_node())),
-  fd_(timerfd_from_ns(config().sensors.read_interval))
+: PollMonitor(trace, "Sensors recorder"), otf2_writer_(trace.create_metric_writer(name()))
 {
 
     sensors_init(nullptr);
 
+    struct FoundSensor
+    {
+        Sensor sensor;
+        std::string name;
+        std::string label;
+        const char* unit;
+    };
+
+    std::map<std::chrono::milliseconds, std::vector<FoundSensor>> found;
+
     // Can I just leave a rant here? This freaking C API is the worst. Who, in gods name, came up
     // with that bullshit? "nr is an internally used variable". For fucks sake. (┛◉Д◉) ┛彡┻━┻
 
@@ -134,60 +227,115 @@ Recorder::Recorder(trace::Trace& trace)
                 sensor_name << chip_name << "/" << feature->name << " (" << label.get() << ")";
                 Log::debug() << "Found sensor: " << sensor_name.str();
 
+                auto read_interval = read_interval_for(sensor_name.str());
+                if (!read_interval)
+                {
+                    continue;
+                }
+
                 // Sometimes, this wonderful API gives us sensors which fail every time
                 // you try to read them. So check if we really can read them
                 double tmp = NAN;
                 if (sensors_get_value(chip, sub_feature->number, &tmp) == 0)
                 {
-                    items_.emplace_back(
-                        std::make_pair<const void*, int>(chip, int(sub_feature->number)));
-                    auto mc = otf2::definition::make_weak_ref(metric_instance_.metric_class());
+                    double const scale = get_scale(feature);
+                    Sensor const sensor{ chip, sub_feature->number,
+                                         open_hwmon_file(chip, sub_feature, scale, tmp), scale };
 
-                    mc->add_member(trace.metric_member(
-                        sensor_name.str(), label.get(), otf2::common::metric_mode::absolute_point,
-                        otf2::common::type::Double, get_unit(feature)));
+                    found[*read_interval].push_back(
+                        { sensor, sensor_name.str(), label.get(), get_unit(feature) });
                 }
             }
         }
     }
 
-    event_ = std::make_unique<otf2::event::metric>(otf2::chrono::genesis(), metric_instance_);
+    for (auto& [read_interval, sensors] : found)
+    {
+        Log::debug() << "Reading " << sensors.size() << " sensors every " << read_interval.count()
+                     << " ms";
+
+        Group group{ timerfd_from_ns(read_interval),
+                     trace.metric_instance(trace.metric_class(), otf2_writer_.location(),
+                                           trace.system_tree_root_node()),
+                     nullptr,
+                     {} };
+
+        auto mc = otf2::definition::make_weak_ref(group.metric_instance.metric_class());
+        for (const auto& sensor : sensors)
+        {
+            mc->add_member(trace.metric_member(sensor.name, sensor.label,
+                                               otf2::common::metric_mode::absolute_point,
+                                               otf2::common::type::Double, sensor.unit));
+            group.sensors.push_back(sensor.sensor);
+        }
+
+        group.event =
+            std::make_unique<otf2::event::metric>(otf2::chrono::genesis(), group.metric_instance);
+
+        add_fd(group.timer_fd);
+        groups_.emplace_back(std::move(group));
+    }
 }
 
-void Recorder::monitor([[maybe_unused]] int fd)
+double Recorder::read_sensor(const Sensor& sensor)
 {
-    // update timestamp
-    event_->timestamp(time::now());
+    double value = NAN;
+    if (sensor.fd != -1 && read_raw(sensor.fd, value))
+    {
+        return value / sensor.scale;
+    }
+
+    int const res = sensors_get_value(reinterpret_cast<const sensors_chip_name*>(sensor.chip),
+                                      sensor.subfeature, &value);
+    if (res < 0)
+    {
+        throw_errno();
+    }
+    return value;
+}
 
-    // update event values with sensors data
-    for (const auto& index_items : nitro::lang::enumerate(items_))
+void Recorder::monitor(int fd)
+{
+    for (auto& group : groups_)
     {
-        double value = NAN;
-        const auto [chip, subf] = index_items.value();
-        int const res =
-            sensors_get_value(reinterpret_cast<const sensors_chip_name*>(chip), subf, &value);
-        if (res < 0)
+        if (group.timer_fd != fd)
         {
-            throw_errno();
+            continue;
         }
 
-        auto i = index_items.index();
-        event_->raw_values()[i] = value;
-    }
+        uint64_t num_expirations [[maybe_unused]] = 0;
+        if (::read(fd, &num_expirations, sizeof(uint64_t)) == -1 && errno != EAGAIN)
+        {
+            throw_errno();
+        }
 
-    // write event to archive
-    otf2_writer_.write(*event_);
+        // update timestamp
+        group.event->timestamp(time::now());
 
-    uint64_t num_expirations [[maybe_unused]] = 0;
+        // update event values with sensors data
+        for (const auto& index_sensor : nitro::lang::enumerate(group.sensors))
+        {
+            group.event->raw_values()[index_sensor.index()] = read_sensor(index_sensor.value());
+        }
 
-    if (::read(fd_, &num_expirations, sizeof(uint64_t)) != sizeof(uint64_t))
-    {
-        throw_errno();
+        // write event to archive
+        otf2_writer_.write(*group.event);
     }
 }
 
 Recorder::~Recorder()
 {
+    for (auto& group : groups_)
+    {
+        for (auto& sensor : group.sensors)
+        {
+            if (sensor.fd != -1)
+            {
+                ::close(sensor.fd);
+            }
+        }
+        ::close(group.timer_fd);
+    }
     sensors_cleanup();
 }
 } // namespace lo2s::metric::sensors
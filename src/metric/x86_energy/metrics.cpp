@@ -4,6 +4,7 @@
 
 #include <lo2s/metric/x86_energy/metrics.hpp>
 
+#include <lo2s/config.hpp>
 #include <lo2s/log.hpp>
 #include <lo2s/metric/x86_energy/monitor.hpp>
 #include <lo2s/topology.hpp>
@@ -21,6 +22,8 @@
 #include <string>
 #include <utility>
 
+#include <fmt/format.h>
+
 namespace xe = x86_energy;
 
 namespace lo2s::metric::x86_energy
@@ -62,6 +65,17 @@ Metrics::Metrics(trace::Trace& trace)
     // if we get here, we have at least one access source to collect metric data from
     Log::info() << "Using x86_energy access source: " << active_source->name();
 
+    if (config().x86_energy.single_thread)
+    {
+        // A single monitor reads all the counters, optionally pinned to a housekeeping cpu
+        auto cpu = Cpu::invalid();
+        if (config().x86_energy.cpu != -1)
+        {
+            cpu = Cpu(config().x86_energy.cpu);
+        }
+        recorders_.emplace_back(std::make_unique<Monitor>(trace, "x86_energy monitor", cpu));
+    }
+
     // okay, we have
     for (int i = 0; i < static_cast<int>(xe::Counter::SIZE); i++)
     {
@@ -134,8 +148,12 @@ Metrics::Metrics(trace::Trace& trace)
                 stn = trace.system_tree_root_node();
             }
 
-            recorders_.emplace_back(
-                std::make_unique<Monitor>(active_source->get(counter, index), cpu, trace, mc, stn));
+            if (!config().x86_energy.single_thread)
+            {
+                recorders_.emplace_back(
+                    std::make_unique<Monitor>(trace, fmt::format("{}", cpu), cpu));
+            }
+            recorders_.back()->add_counter(active_source->get(counter, index), cpu, mc, stn);
         }
     }
 }
@@ -4,7 +4,10 @@
 
 #include <lo2s/metric/x86_energy/monitor.hpp>
 
+#include <lo2s/config.hpp>
+#include <lo2s/error.hpp>
 #include <lo2s/execution_scope.hpp>
+#include <lo2s/log.hpp>
 #include <lo2s/monitor/poll_monitor.hpp>
 #include <lo2s/time/time.hpp>
 #include <lo2s/trace/trace.hpp>
@@ -16,34 +19,77 @@
 #include <otf2xx/definition/system_tree_node.hpp>
 #include <x86_energy.hpp>
 
+#include <string>
 #include <utility>
 
+#include <cerrno>
+#include <cstdint>
+
 #include <fmt/format.h>
 
+extern "C"
+{
+#include <unistd.h>
+}
+
 namespace lo2s::metric::x86_energy
 {
 
-Monitor::Monitor(::x86_energy::SourceCounter counter, Cpu cpu, trace::Trace& trace,
-                 const otf2::definition::metric_class& metric_class,
-                 const otf2::definition::system_tree_node& stn)
-: PollMonitor(trace, fmt::format("{}", cpu)), counter_(std::move(counter)), cpu_(cpu),
-  otf2_writer_(trace.create_metric_writer(name())),
-  metric_instance_(trace.metric_instance(metric_class, otf2_writer_.location(), stn)),
-  metric_event_(otf2::chrono::genesis(), metric_instance_)
-// (WOW this is (almost) better than LISP)
+Monitor::Counter::Counter(::x86_energy::SourceCounter counter, otf2::writer::local& writer,
+                          const otf2::definition::metric_instance& metric_instance)
+: counter(std::move(counter)), writer(writer),
+  metric_event(otf2::chrono::genesis(), metric_instance)
+{
+}
+
+Monitor::Monitor(trace::Trace& trace, const std::string& name, Cpu pin_cpu)
+: PollMonitor(trace, name), pin_cpu_(pin_cpu),
+  timer_fd_(timerfd_from_ns(config().x86_energy.read_interval))
+{
+    add_fd(timer_fd_);
+}
+
+Monitor::~Monitor()
 {
+    close(timer_fd_);
+}
+
+void Monitor::add_counter(::x86_energy::SourceCounter counter, Cpu cpu,
+                          const otf2::definition::metric_class& metric_class,
+                          const otf2::definition::system_tree_node& stn)
+{
+    // Every counter gets its own metric location, no matter which thread reads it
+    auto& writer = trace_.create_metric_writer(fmt::format("{}", cpu));
+    counters_.emplace_back(std::move(counter), writer,
+                           trace_.metric_instance(metric_class, writer.location(), stn));
 }
 
 void Monitor::initialize_thread()
 {
-    try_pin_to_scope(ExecutionScope(cpu_));
+    if (pin_cpu_ != Cpu::invalid())
+    {
+        try_pin_to_scope(ExecutionScope(pin_cpu_));
+    }
 }
 
-void Monitor::monitor([[maybe_unused]] int fd)
+void Monitor::monitor(int fd)
 {
-    metric_event_.timestamp(time::now());
-    metric_event_.raw_values()[0] = counter_.read();
+    if (fd == timer_fd_)
+    {
+        [[maybe_unused]] uint64_t expirations = 0;
+        if (read(timer_fd_, &expirations, sizeof(expirations)) == -1 && errno != EAGAIN)
+        {
+            Log::error() << "Flushing timer fd failed";
+            throw_errno();
+        }
+    }
+
+    for (auto& counter : counters_)
+    {
+        counter.metric_event.timestamp(time::now());
+        counter.metric_event.raw_values()[0] = counter.counter.read();
 
-    otf2_writer_.write(metric_event_);
+        counter.writer.write(counter.metric_event);
+    }
 }
 } // namespace lo2s::metric::x86_energy
@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <lo2s/monitor/bpf_monitor.hpp>
+
+#include <lo2s/error.hpp>
+#include <lo2s/log.hpp>
+#include <lo2s/monitor/threaded_monitor.hpp>
+#include <lo2s/overhead.hpp>
+#include <lo2s/types/thread.hpp>
+
+#include <chrono>
+#include <string>
+#include <utility>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <linux/bpf.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+
+namespace lo2s::monitor
+{
+BpfMonitor::BpfMonitor(trace::Trace& trace, const std::string& name, std::string program,
+                       std::string events)
+: ThreadedMonitor(trace, name), program_(std::move(program)), events_(std::move(events))
+{
+    // Need to bump memlock rlimit to run anything but the most trivial BPF programs
+    struct rlimit rlim_new;
+    rlim_new.rlim_cur = RLIM_INFINITY;
+    rlim_new.rlim_max = RLIM_INFINITY;
+
+    if (setrlimit(RLIMIT_MEMLOCK, &rlim_new))
+    {
+        Log::error() << "Could not increase memlock rlimit, can not load " << program_
+                     << " BPF program";
+        throw_errno();
+    }
+}
+
+void BpfMonitor::open_ring_buffer(struct bpf_map* rb, struct bpf_map* pids,
+                                  struct bpf_map* lost)
+{
+    pids_ = pids;
+    lost_ = lost;
+
+    rb_ = std::unique_ptr<struct ring_buffer, RingBufferDeleter>(
+        ring_buffer__new(bpf_map__fd(rb), event_cb, this, NULL));
+
+    if (!rb_)
+    {
+        Log::error() << "Could not attach to " << program_ << " BPF ring buffer";
+        throw_errno();
+    }
+}
+
+int BpfMonitor::event_cb(void* ctx, void* data, size_t datasz)
+{
+    static_cast<BpfMonitor*>(ctx)->handle_event(data, datasz);
+    return 0;
+}
+
+void BpfMonitor::insert_thread(Thread thread)
+{
+    char insert = 1;
+    pid_t pid = thread.as_int();
+    bpf_map__update_elem(pids_, &pid, sizeof(pid), &insert, sizeof(char), BPF_ANY);
+}
+
+void BpfMonitor::exit_thread(Thread thread)
+{
+    pid_t pid = thread.as_int();
+    bpf_map__delete_elem(pids_, &pid, sizeof(pid), BPF_ANY);
+}
+
+void BpfMonitor::run()
+{
+    while (!stop_)
+    {
+        auto poll_start = std::chrono::steady_clock::now();
+        auto records = ring_buffer__poll(rb_.get(), POLL_TIMEOUT);
+
+        if (overhead_)
+        {
+            if (records > 0)
+            {
+                // libbpf does not expose the fill level of the ring buffer
+                Overhead::thread().record_drain(records, 0, 0);
+                overhead_->wakeup(std::chrono::steady_clock::now() - poll_start);
+            }
+            overhead_->update();
+        }
+
+        monitor();
+    }
+
+    ring_buffer__consume(rb_.get());
+
+    uint32_t key = 0;
+    uint64_t lost = 0;
+    if (lost_ != nullptr &&
+        bpf_map__lookup_elem(lost_, &key, sizeof(key), &lost, sizeof(lost), 0) == 0 && lost > 0)
+    {
+        Log::warn() << "Lost " << lost << " " << events_ << ", the BPF ring buffer was full";
+    }
+}
+
+void BpfMonitor::stop()
+{
+    stop_ = true;
+    thread_.join();
+}
+} // namespace lo2s::monitor
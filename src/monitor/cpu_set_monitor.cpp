@@ -10,9 +10,12 @@
 #include <lo2s/log.hpp>
 #include <lo2s/monitor/process_monitor_main.hpp>
 #include <lo2s/monitor/system_process_monitor.hpp>
+#include <lo2s/perf/event_handover.hpp>
 #include <lo2s/topology.hpp>
+#include <lo2s/trace/trace.hpp>
 #include <lo2s/util.hpp>
 
+#include <chrono>
 #include <filesystem>
 #include <iostream>
 #include <regex>
@@ -23,7 +26,9 @@
 #include <utility>
 
 #include <cassert>
+#include <cerrno>
 #include <csignal>
+#include <ctime>
 
 extern "C"
 {
@@ -62,7 +67,8 @@ CpuSetMonitor::CpuSetMonitor()
         }
     }
 
-    if (config().perf.sampling.enabled || config().perf.sampling.process_recording)
+    if (config().perf.sampling.enabled || config().perf.sampling.process_recording ||
+        config().perf.syscall.bpf())
     {
         trace_.emplace_threads(get_comms_for_running_threads());
     }
@@ -95,10 +101,70 @@ CpuSetMonitor::CpuSetMonitor()
 
         throw;
     }
+
+#ifdef HAVE_BPF
+    if (config().perf.syscall.bpf())
+    {
+        syscall_monitor_ = std::make_unique<SyscallMonitor>(trace_, false);
+        syscall_monitor_->start();
+    }
+
+    if (config().perf.sampling.off_cpu)
+    {
+        off_cpu_monitor_ = std::make_unique<OffCpuMonitor>(trace_, false);
+        off_cpu_monitor_->start();
+    }
+#endif
+
+    // All the events of the previous trace that are still needed have been taken over
+    perf::EventHandover::instance().end();
 }
 
-void CpuSetMonitor::run()
+bool CpuSetMonitor::wait_for_sigint_or_rotation(sigset_t& ss)
 {
+    const auto& otf2_config = config().otf2;
+
+    if (otf2_config.rotate_interval.count() == 0 && otf2_config.rotate_size == 0)
+    {
+        int sig = 0;
+        auto ret = sigwait(&ss, &sig);
+        if (ret)
+        {
+            throw make_system_error();
+        }
+        return false;
+    }
+
+    const auto rotate_at = std::chrono::steady_clock::now() + otf2_config.rotate_interval;
+    while (true)
+    {
+        // Wake up regularly to check the size of the trace
+        struct timespec timeout = { 1, 0 };
+        if (sigtimedwait(&ss, nullptr, &timeout) != -1)
+        {
+            return false;
+        }
+        if (errno != EAGAIN && errno != EINTR)
+        {
+            throw_errno();
+        }
+
+        if (otf2_config.rotate_interval.count() != 0 &&
+            std::chrono::steady_clock::now() >= rotate_at)
+        {
+            return true;
+        }
+        if (otf2_config.rotate_size != 0 && trace_.budget().written() >= otf2_config.rotate_size)
+        {
+            return true;
+        }
+    }
+}
+
+bool CpuSetMonitor::run()
+{
+    bool rotate = false;
+
     sigset_t ss;
     if (config().put.command.empty() && config().general.process == Process::invalid())
     {
@@ -115,13 +181,19 @@ void CpuSetMonitor::run()
 
     if (config().put.command.empty() && config().general.process == Process::invalid())
     {
-        int sig = 0;
-        auto ret = sigwait(&ss, &sig);
-        std::cout << "[ lo2s: Encountered SIGINT. Stopping measurements and closing trace ]"
-                  << std::endl;
-        if (ret)
+        rotate = wait_for_sigint_or_rotation(ss);
+        if (rotate)
         {
-            throw make_system_error();
+            Log::info() << "Closing trace, continuing recording in a new one";
+
+            // Keep the perf events of the monitors that are stopped below open for the monitors
+            // of the next trace, which continue reading them where they were drained
+            perf::EventHandover::instance().begin();
+        }
+        else
+        {
+            std::cout << "[ lo2s: Encountered SIGINT. Stopping measurements and closing trace ]"
+                      << std::endl;
         }
     }
     else
@@ -140,7 +212,8 @@ void CpuSetMonitor::run()
         }
     }
 
-    if (config().perf.sampling.enabled || config().perf.sampling.process_recording)
+    if (config().perf.sampling.enabled || config().perf.sampling.process_recording ||
+        config().perf.syscall.bpf())
     {
         trace_.emplace_threads(get_comms_for_running_threads());
     }
@@ -151,6 +224,22 @@ void CpuSetMonitor::run()
         monitor_elem.second.emplace_resolvers(resolvers_);
     }
 
+#ifdef HAVE_BPF
+    if (syscall_monitor_)
+    {
+        syscall_monitor_->stop();
+    }
+    if (off_cpu_monitor_)
+    {
+        off_cpu_monitor_->stop();
+    }
+#endif
+
+    if (rotate)
+    {
+        return true;
+    }
+
     throw std::system_error(0, std::system_category());
 }
 } // namespace lo2s::monitor
@@ -11,6 +11,7 @@
 #include <lo2s/gpu/events.hpp>
 #include <lo2s/measurement_scope.hpp>
 #include <lo2s/monitor/poll_monitor.hpp>
+#include <lo2s/overhead.hpp>
 #include <lo2s/perf/time/converter.hpp>
 #include <lo2s/trace/trace.hpp>
 
@@ -40,6 +41,9 @@ void GPUMonitor::finalize_thread()
 
 void GPUMonitor::monitor(int fd [[maybe_unused]])
 {
+    const auto used = ringbuf_reader_.used();
+    uint64_t records = 0;
+
     while (!ringbuf_reader_.empty())
     {
         const uint64_t event_type = ringbuf_reader_.get_top_event_type();
@@ -67,6 +71,9 @@ void GPUMonitor::monitor(int fd [[maybe_unused]])
         }
 
         ringbuf_reader_.pop();
+        records++;
     }
+
+    Overhead::thread().record_drain(records, used, ringbuf_reader_.size());
 }
 } // namespace lo2s::monitor
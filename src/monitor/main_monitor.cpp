@@ -9,6 +9,7 @@
 #include <lo2s/metric/sensors/recorder.hpp>
 #include <lo2s/monitor/io_monitor.hpp>
 #include <lo2s/monitor/socket_monitor.hpp>
+#include <lo2s/monitor/trace_size_monitor.hpp>
 #include <lo2s/monitor/tracepoint_monitor.hpp>
 #include <lo2s/perf/bio/writer.hpp>
 #include <lo2s/perf/time/converter.hpp>
@@ -110,6 +111,12 @@ MainMonitor::MainMonitor() : metrics_(trace_)
     }
 #endif
 
+    if (config().otf2.report_size_interval.count() != 0)
+    {
+        trace_size_monitor_ = std::make_unique<TraceSizeMonitor>(trace_);
+        trace_size_monitor_->start();
+    }
+
     try
     {
         socket_monitor_ = std::make_unique<SocketMonitor>(trace_);
@@ -132,6 +139,11 @@ MainMonitor::~MainMonitor()
     }
 #endif
 
+    if (trace_size_monitor_)
+    {
+        trace_size_monitor_->stop();
+    }
+
     if (socket_monitor_)
     {
         socket_monitor_->stop();
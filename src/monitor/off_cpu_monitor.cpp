@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <lo2s/monitor/off_cpu_monitor.hpp>
+
+#include <lo2s/calling_context.hpp>
+#include <lo2s/config.hpp>
+#include <lo2s/error.hpp>
+#include <lo2s/local_cctx_tree.hpp>
+#include <lo2s/log.hpp>
+#include <lo2s/measurement_scope.hpp>
+#include <lo2s/monitor/bpf_monitor.hpp>
+#include <lo2s/perf/off_cpu/common.h>
+#include <lo2s/perf/time/converter.hpp>
+#include <lo2s/trace/budget.hpp>
+#include <lo2s/trace/trace.hpp>
+#include <lo2s/types/process.hpp>
+#include <lo2s/types/thread.hpp>
+
+#include <algorithm>
+#include <memory>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <unistd.h>
+
+namespace lo2s::monitor
+{
+OffCpuMonitor::OffCpuMonitor(trace::Trace& trace, bool filter_threads)
+: BpfMonitor(trace, "off-CPU monitor", "off-CPU", "off-CPU intervals"), trace_(trace),
+  time_converter_(perf::time::Converter::instance())
+{
+    skel_ = decltype(skel_)(off_cpu_bpf__open());
+    if (!skel_)
+    {
+        Log::error() << "Could not open off-CPU BPF program";
+        throw_errno();
+    }
+
+    const auto& sampling_config = config().perf.sampling;
+
+    // The read-only data of the program can only be set between open and load
+    skel_->rodata->min_duration = sampling_config.off_cpu_threshold.count();
+    skel_->rodata->filter_pids = filter_threads;
+    skel_->rodata->lo2s_pid = getpid();
+    skel_->rodata->exclude_kernel = sampling_config.exclude_kernel;
+
+    if (off_cpu_bpf__load(skel_.get()) < 0)
+    {
+        Log::error() << "Could not load off-CPU BPF program";
+        throw_errno();
+    }
+
+    if (off_cpu_bpf__attach(skel_.get()) < 0)
+    {
+        Log::error() << "Could not attach off-CPU BPF program to the sched_switch tracepoint";
+        throw_errno();
+    }
+
+    open_ring_buffer(skel_->maps.rb, skel_->maps.pids, skel_->maps.lost);
+}
+
+void OffCpuMonitor::handle_event(void* data, size_t datasz [[maybe_unused]])
+{
+    auto* e = reinterpret_cast<struct off_cpu_event*>(data);
+
+    if (trace_.budget().degraded(trace::Degradation::DROPPING))
+    {
+        trace_.budget().drop();
+        return;
+    }
+
+    Thread const thread(e->tid);
+
+    auto it = local_cctx_trees_.find(thread);
+    if (it == local_cctx_trees_.end())
+    {
+        it = local_cctx_trees_
+                 .emplace(thread, &trace_.create_local_cctx_tree(
+                                      MeasurementScope::off_cpu(thread.as_scope())))
+                 .first;
+    }
+
+    // A thread can only block once at a time, and the ring buffer keeps the submission order, so
+    // the intervals of every thread are written in order.
+    auto& local_cctx_tree = *it->second;
+    auto start = time_converter_(e->start_time);
+
+    local_cctx_tree.cctx_enter(start, CCTX_LEVEL_PROCESS, CallingContext::process(Process(e->pid)),
+                               CallingContext::thread(thread));
+
+    // The callchains are leaf first, but have to be entered starting from the outermost frame.
+    // The kernel part is called from the user part.
+    uint64_t level = CCTX_LEVEL_PROCESS + 2;
+    const int num_user_ips = std::clamp(e->num_user_ips, 0, OFF_CPU_MAX_FRAMES);
+    for (int i = num_user_ips - 1; i >= 0; i--)
+    {
+        local_cctx_tree.cctx_enter(start, level++, CallingContext::sample(e->user_ips[i]));
+    }
+    const int num_kernel_ips = std::clamp(e->num_kernel_ips, 0, OFF_CPU_MAX_FRAMES);
+    for (int i = num_kernel_ips - 1; i >= 0; i--)
+    {
+        local_cctx_tree.cctx_enter(start, level++, CallingContext::sample(e->kernel_ips[i]));
+    }
+
+    local_cctx_tree.cctx_leave(time_converter_(e->end_time), CCTX_LEVEL_PROCESS);
+
+    trace_.budget().account(2 * level * trace::Budget::EVENT_SIZE);
+}
+
+void OffCpuMonitor::finalize_thread()
+{
+    for (auto& local_cctx_tree : local_cctx_trees_)
+    {
+        local_cctx_tree.second->finalize();
+    }
+}
+} // namespace lo2s::monitor
@@ -8,6 +8,7 @@
 #include <lo2s/config.hpp>
 #include <lo2s/measurement_scope.hpp>
 #include <lo2s/monitor/poll_monitor.hpp>
+#include <lo2s/overhead.hpp>
 #include <lo2s/ompt/events.hpp>
 #include <lo2s/perf/time/converter.hpp>
 #include <lo2s/trace/trace.hpp>
@@ -47,6 +48,9 @@ void OpenMPMonitor::create_thread_writer(otf2::chrono::time_point tp, uint64_t t
 
 void OpenMPMonitor::monitor(int fd [[maybe_unused]])
 {
+    const auto used = ringbuf_reader_.used();
+    uint64_t records = 0;
+
     while (!ringbuf_reader_.empty())
     {
         auto event_type = static_cast<ompt::EventType>(ringbuf_reader_.get_top_event_type());
@@ -87,6 +91,9 @@ void OpenMPMonitor::monitor(int fd [[maybe_unused]])
         }
 
         ringbuf_reader_.pop();
+        records++;
     }
+
+    Overhead::thread().record_drain(records, used, ringbuf_reader_.size());
 }
 } // namespace lo2s::monitor
@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <lo2s/monitor/overhead_recorder.hpp>
+
+#include <lo2s/error.hpp>
+#include <lo2s/overhead.hpp>
+#include <lo2s/time/time.hpp>
+#include <lo2s/trace/budget.hpp>
+#include <lo2s/trace/trace.hpp>
+
+#include <otf2xx/chrono/time_point.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+#include <ctime>
+
+#include <fmt/format.h>
+
+namespace lo2s::monitor
+{
+namespace
+{
+std::chrono::nanoseconds thread_cpu_time()
+{
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == -1)
+    {
+        throw_errno();
+    }
+    return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+}
+} // namespace
+
+OverheadRecorder::OverheadRecorder(trace::Trace& trace, const std::string& name)
+: trace_(trace), writer_(trace.create_metric_writer(fmt::format("{} overhead", name))),
+  event_(otf2::chrono::genesis(),
+         trace.metric_instance(trace.overhead_metric_class(), writer_.location(),
+                               trace.system_tree_root_node())),
+  last_update_(std::chrono::steady_clock::now())
+{
+}
+
+void OverheadRecorder::update()
+{
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_update_ < INTERVAL)
+    {
+        return;
+    }
+
+    std::chrono::duration<double> const elapsed = now - last_update_;
+    auto& current = Overhead::thread();
+    auto cpu_time = thread_cpu_time();
+
+    auto drains = current.drains - last_.drains;
+    auto records = current.records - last_.records;
+
+    event_.timestamp(time::now());
+    event_.raw_values()[0] = wakeups_ / elapsed.count();
+    event_.raw_values()[1] = drains == 0 ? 0.0 : static_cast<double>(records) / drains;
+    event_.raw_values()[2] =
+        wakeups_ == 0 ? 0.0
+                      : std::chrono::duration<double, std::micro>(latency_).count() / wakeups_;
+    event_.raw_values()[3] = (current.bytes - last_.bytes) / elapsed.count();
+    event_.raw_values()[4] =
+        100 * std::chrono::duration<double>(cpu_time - last_cpu_time_).count() / elapsed.count();
+    event_.raw_values()[5] = current.max_fill / 10.0;
+    writer_.write(event_);
+    trace_.budget().account_metric(6);
+
+    current.max_fill = 0;
+    last_ = current;
+    last_cpu_time_ = cpu_time;
+    last_update_ = now;
+    wakeups_ = 0;
+    latency_ = {};
+}
+
+int OverheadRecorder::timeout() const
+{
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+        last_update_ + INTERVAL - std::chrono::steady_clock::now());
+    return std::max<int>(0, remaining.count());
+}
+} // namespace lo2s::monitor
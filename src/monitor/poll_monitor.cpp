@@ -7,9 +7,11 @@
 #include <lo2s/error.hpp>
 #include <lo2s/log.hpp>
 #include <lo2s/monitor/threaded_monitor.hpp>
+#include <lo2s/stream/stream.hpp>
 #include <lo2s/trace/trace.hpp>
 
-#include <stdexcept>
+#include <algorithm>
+#include <chrono>
 #include <string>
 
 #include <cstdint>
@@ -66,19 +68,40 @@ void PollMonitor::monitor()
     }
 }
 
+int PollMonitor::poll_timeout()
+{
+    // With overhead metrics, wake up at least once per interval to write them
+    int timeout = overhead_ ? overhead_->timeout() : -1;
+
+    // With a stream, wake up when the next batch is due, so that batches of an idle scope do not
+    // wait for its next record
+    auto stream_timeout = trace_.stream().flush_due();
+    if (stream_timeout)
+    {
+        int const ms = static_cast<int>(stream_timeout->count());
+        timeout = timeout == -1 ? ms : std::min(timeout, ms);
+    }
+    return timeout;
+}
+
 void PollMonitor::run()
 {
     bool stop_requested = false;
     while (!stop_requested)
     {
-        auto ret = ::poll(pfds_.data(), pfds_.size(), -1);
-        num_wakeups_++;
+        auto ret = ::poll(pfds_.data(), pfds_.size(), poll_timeout());
 
         if (ret == 0)
         {
-            throw std::runtime_error("Received poll timeout despite requesting no timeout.");
+            if (overhead_)
+            {
+                overhead_->update();
+            }
+            continue;
         }
 
+        num_wakeups_++;
+
         if (ret < 0)
         {
             Log::error() << "poll failed";
@@ -102,8 +125,15 @@ void PollMonitor::run()
             break;
         }
 
+        auto monitor_start = std::chrono::steady_clock::now();
         monitor();
 
+        if (overhead_)
+        {
+            overhead_->wakeup(std::chrono::steady_clock::now() - monitor_start);
+            overhead_->update();
+        }
+
         if (stop_pfd().revents & POLLIN)
         {
             Log::debug() << "Requested stop of PollMonitor";
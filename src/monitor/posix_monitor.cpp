@@ -5,9 +5,12 @@
 
 #include <lo2s/error.hpp>
 #include <lo2s/log.hpp>
-#include <lo2s/monitor/threaded_monitor.hpp>
+#include <lo2s/monitor/bpf_monitor.hpp>
 #include <lo2s/perf/posix_io/common.h>
 #include <lo2s/perf/time/converter.hpp>
+#include <lo2s/stream/format.hpp>
+#include <lo2s/stream/stream.hpp>
+#include <lo2s/trace/budget.hpp>
 #include <lo2s/trace/trace.hpp>
 #include <lo2s/types/thread.hpp>
 
@@ -21,38 +24,16 @@
 
 #include <cstddef>
 
-#include <linux/bpf.h>
 #include <sched.h>
-#include <sys/resource.h>
 
 namespace lo2s::monitor
 {
-namespace
-{
-
-int event_cb(void* ctx, void* data, size_t data_sz)
-{
-    reinterpret_cast<PosixMonitor*>(ctx)->handle_event(data, data_sz);
-    return 0;
-}
-} // namespace
-
 PosixMonitor::PosixMonitor(trace::Trace& trace)
-: ThreadedMonitor(trace, "open() monitor"), trace_(trace),
-  time_converter_(perf::time::Converter::instance())
+: BpfMonitor(trace, "open() monitor", "POSIX I/O", "POSIX I/O events"), trace_(trace),
+  time_converter_(perf::time::Converter::instance()),
+  stream_(trace.stream(), stream::SourceType::IO, "POSIX I/O")
 {
-    // Need to bump memlock rlimit to run anything but the most trivial BPF programs
-    struct rlimit rlim_new;
-    rlim_new.rlim_cur = RLIM_INFINITY;
-    rlim_new.rlim_max = RLIM_INFINITY;
-
-    if (setrlimit(RLIMIT_MEMLOCK, &rlim_new))
-    {
-        Log::error() << "Could not increase memlock rlimit, can not load POSIX I/O BPF program";
-        throw_errno();
-    }
-
-    skel_ = std::unique_ptr<struct posix_io_bpf, SkelDeleter>(posix_io_bpf__open_and_load());
+    skel_ = decltype(skel_)(posix_io_bpf__open_and_load());
     if (!skel_)
     {
         Log::error() << "Could not open and load POSIX I/O BPF program";
@@ -65,35 +46,16 @@ PosixMonitor::PosixMonitor(trace::Trace& trace)
         throw_errno();
     }
 
-    rb_ = std::unique_ptr<struct ring_buffer, RingBufferDeleter>(
-        ring_buffer__new(bpf_map__fd(skel_.get()->maps.rb), event_cb, this, NULL));
-
-    if (!rb_)
-    {
-        Log::error() << "Could not attach to POSIX I/O BPF ring buffer";
-        throw_errno();
-    }
+    // posix_io.bpf.c does not count the events it could not submit
+    open_ring_buffer(skel_->maps.rb, skel_->maps.pids, nullptr);
 }
 
-// Inserts new thread into list of threads whose POSIX I/O should be recorded.
-// This information is communicated to the BPF program via a BPF map.
 void PosixMonitor::insert_thread(Thread thread)
 {
-    char insert = 1;
-    pid_t pid = thread.as_int();
-    bpf_map__update_elem(skel_->maps.pids, &pid, sizeof(pid), &insert, sizeof(char), BPF_ANY);
-
+    BpfMonitor::insert_thread(thread);
     last_fd_[thread] = -1;
 }
 
-// Removes thread from list of threads whose POSIX I/O should be recorded
-void PosixMonitor::exit_thread(Thread thread)
-{
-    pid_t pid = thread.as_int();
-    bpf_map__delete_elem(skel_->maps.pids, &pid, sizeof(pid), BPF_ANY);
-}
-
-// General assumption here: A thread will at all times only be in one read()/write() call.
 void PosixMonitor::handle_event(void* data, size_t datasz [[maybe_unused]])
 {
     auto* e = reinterpret_cast<struct posix_event_header*>(data);
@@ -175,6 +137,13 @@ void PosixMonitor::handle_event(void* data, size_t datasz [[maybe_unused]])
 
     if (e->type == READ_ENTER || e->type == WRITE_ENTER)
     {
+        // Dropping the begin of an operation also drops its completion, as last_fd_ stays -1
+        if (trace_.budget().degraded(trace::Degradation::DROPPING))
+        {
+            trace_.budget().drop();
+            return;
+        }
+
         auto* event = reinterpret_cast<read_write_event*>(data);
 
         // When writing the IoOperationComplete event for a Begin, we have to use the fd of the
@@ -200,6 +169,9 @@ void PosixMonitor::handle_event(void* data, size_t datasz [[maybe_unused]])
             time_converter_(event->header.time), handle, mode,
             otf2::common::io_operation_flag_type::non_blocking, event->count, event->buf);
         // NOLINTEND(misc-const-correctness)
+        stream_.io(stream::RecordType::IO_BEGIN, time_converter_(event->header.time), handle.ref(),
+                   static_cast<uint64_t>(mode), event->count, event->buf);
+        trace_.budget().account(trace::Budget::EVENT_SIZE);
     }
     else if (e->type == READ_EXIT || e->type == WRITE_EXIT)
     {
@@ -220,22 +192,11 @@ void PosixMonitor::handle_event(void* data, size_t datasz [[maybe_unused]])
         writer << otf2::event::io_operation_complete(time_converter_(e->time), handle,
                                                      last_count_[thread], last_buf_[thread]);
         // NOLINTEND (misc-const-correctness)
+        stream_.io(stream::RecordType::IO_COMPLETE, time_converter_(e->time), handle.ref(),
+                   static_cast<uint64_t>(mode), last_count_[thread], last_buf_[thread]);
+        trace_.budget().account(trace::Budget::EVENT_SIZE);
         last_fd_[thread] = -1;
     }
 }
 
-void PosixMonitor::run()
-{
-    while (!stop_)
-    {
-        ring_buffer__poll(rb_.get(), 100);
-    }
-}
-
-void PosixMonitor::stop()
-{
-    stop_ = true;
-    thread_.join();
-}
-
 } // namespace lo2s::monitor
@@ -30,6 +30,18 @@ ProcessMonitor::ProcessMonitor()
         posix_monitor_ = std::make_unique<PosixMonitor>(trace_);
         posix_monitor_->start();
     }
+
+    if (config().perf.syscall.bpf())
+    {
+        syscall_monitor_ = std::make_unique<SyscallMonitor>(trace_, true);
+        syscall_monitor_->start();
+    }
+
+    if (config().perf.sampling.off_cpu)
+    {
+        off_cpu_monitor_ = std::make_unique<OffCpuMonitor>(trace_, true);
+        off_cpu_monitor_->start();
+    }
 #endif
     trace_.emplace_monitoring_thread(gettid(), "ProcessMonitor", "ProcessMonitor");
 }
@@ -51,6 +63,14 @@ void ProcessMonitor::insert_thread(Process parent [[maybe_unused]], Thread child
     {
         posix_monitor_->insert_thread(child);
     }
+    if (syscall_monitor_)
+    {
+        syscall_monitor_->insert_thread(child);
+    }
+    if (off_cpu_monitor_)
+    {
+        off_cpu_monitor_->insert_thread(child);
+    }
 #endif
     trace_.emplace_thread(parent, child, name);
 
@@ -89,6 +109,14 @@ void ProcessMonitor::exit_thread(Thread thread)
     {
         posix_monitor_->exit_thread(thread);
     }
+    if (syscall_monitor_)
+    {
+        syscall_monitor_->exit_thread(thread);
+    }
+    if (off_cpu_monitor_)
+    {
+        off_cpu_monitor_->exit_thread(thread);
+    }
 #endif
     if (threads_.count(thread) != 0)
     {
@@ -110,6 +138,14 @@ ProcessMonitor::~ProcessMonitor()
     {
         posix_monitor_->stop();
     }
+    if (syscall_monitor_)
+    {
+        syscall_monitor_->stop();
+    }
+    if (off_cpu_monitor_)
+    {
+        off_cpu_monitor_->stop();
+    }
 #endif
 }
 } // namespace lo2s::monitor
@@ -176,6 +176,8 @@ std::vector<char*> to_vector_of_c_str(const std::vector<std::string>& vec)
     if (config().accel.nvidia)
     {
         env.emplace("CUDA_INJECTION64_PATH", "liblo2s_injection.so");
+        env.emplace("LO2S_CUPTI_BUFFER_SIZE", std::to_string(config().accel.cupti_buffer_size));
+        env.emplace("LO2S_CUPTI_BUFFER_COUNT", std::to_string(config().accel.cupti_buffer_count));
     }
 #endif
 
@@ -7,6 +7,7 @@
 #include <lo2s/config.hpp>
 #include <lo2s/execution_scope.hpp>
 #include <lo2s/log.hpp>
+#include <lo2s/numa.hpp>
 #include <lo2s/monitor/poll_monitor.hpp>
 #include <lo2s/perf/counter/group/writer.hpp>
 #include <lo2s/perf/counter/userspace/writer.hpp>
@@ -16,6 +17,7 @@
 #include <lo2s/util.hpp>
 
 #include <memory>
+#include <optional>
 
 namespace lo2s::monitor
 {
@@ -23,13 +25,23 @@ namespace lo2s::monitor
 ScopeMonitor::ScopeMonitor(ExecutionScope scope, trace::Trace& trace, bool enable_on_exec)
 : PollMonitor(trace, scope.name()), scope_(scope)
 {
+    // Create the perf buffers and the writers on the NUMA node of the scope, the monitor thread
+    // itself will later prefer that node for its allocations, see update_numa_node()
+    std::optional<NumaPlacement> placement;
+    if (config().perf.numa_placement)
+    {
+        numa_node_ = numa_node_of_scope(scope);
+        Log::debug() << "NUMA node of " << scope.name() << ": " << numa_node_;
+        placement.emplace(numa_node_);
+    }
+
     if (config().perf.sampling.enabled || config().perf.sampling.process_recording)
     {
         sample_writer_ = std::make_unique<perf::sample::Writer>(scope, trace, enable_on_exec);
         add_fd(sample_writer_->fd());
     }
 
-    if (config().perf.syscall.enabled)
+    if (config().perf.syscall.enabled && !config().perf.syscall.bpf())
     {
         syscall_writer_ = std::make_unique<perf::syscall::Writer>(scope, trace);
         add_fd(syscall_writer_->fd());
@@ -55,6 +67,22 @@ ScopeMonitor::ScopeMonitor(ExecutionScope scope, trace::Trace& trace, bool enabl
 void ScopeMonitor::initialize_thread()
 {
     try_pin_to_scope(scope_);
+
+    if (config().perf.numa_placement)
+    {
+        try_prefer_numa_node(numa_node_);
+    }
+}
+
+void ScopeMonitor::update_numa_node()
+{
+    // The monitored thread might have been moved to a different node since the last wakeup
+    auto node = numa_node_of_scope(scope_);
+    if (node != numa_node_)
+    {
+        numa_node_ = node;
+        try_prefer_numa_node(numa_node_);
+    }
 }
 
 void ScopeMonitor::finalize_thread()
@@ -68,6 +96,16 @@ void ScopeMonitor::finalize_thread()
     {
         syscall_writer_->stop();
     }
+
+    if (group_counter_writer_)
+    {
+        group_counter_writer_->end();
+    }
+
+    if (userspace_counter_writer_)
+    {
+        userspace_counter_writer_->end();
+    }
 }
 
 void ScopeMonitor::monitor(int fd)
@@ -75,6 +113,11 @@ void ScopeMonitor::monitor(int fd)
     if (!scope_.is_cpu())
     {
         try_pin_to_scope(scope_);
+
+        if (config().perf.numa_placement)
+        {
+            update_numa_node();
+        }
     }
 
     if (syscall_writer_ && (fd == stop_pfd().fd || syscall_writer_->fd() == fd))
@@ -6,10 +6,13 @@
 
 #include <lo2s/config.hpp>
 #include <lo2s/error.hpp>
+#include <lo2s/log.hpp>
 #include <lo2s/monitor/gpu_monitor.hpp>
 #include <lo2s/monitor/poll_monitor.hpp>
+#include <lo2s/numa.hpp>
 #include <lo2s/rb/header.hpp>
 #include <lo2s/trace/trace.hpp>
+#include <lo2s/types/thread.hpp>
 
 #include <optional>
 #include <stdexcept>
@@ -101,7 +104,24 @@ void SocketMonitor::monitor(int fd)
     msg.msg_control = control_un.control;
     msg.msg_controllen = sizeof(control_un.control);
 
-    RingbufReader rr(config().perf.clockid.value());
+    RingbufReader rr(config().perf.clockid.value(), config().rb.size, config().rb.huge_pages);
+    if (config().rb.huge_pages && !rr.huge_pages())
+    {
+        Log::warn() << "Not enough huge pages available, using normal pages for the "
+                       "injection library ring-buffer.";
+    }
+
+    // The events are written by the connecting process, so keep the ring-buffer on its node
+    if (config().perf.numa_placement)
+    {
+        struct ucred peer; // NOLINT
+        socklen_t peer_len = sizeof(peer);
+        if (getsockopt(data_socket, SOL_SOCKET, SO_PEERCRED, &peer, &peer_len) == 0)
+        {
+            rr.prefer_numa_node(numa_node_of_scope(Thread(peer.pid).as_scope()));
+        }
+    }
+
     struct cmsghdr* cmptr = CMSG_FIRSTHDR(&msg);
     cmptr->cmsg_len = CMSG_LEN(sizeof(int));
     cmptr->cmsg_level = SOL_SOCKET;
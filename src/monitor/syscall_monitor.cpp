@@ -0,0 +1,171 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <lo2s/monitor/syscall_monitor.hpp>
+
+#include <lo2s/calling_context.hpp>
+#include <lo2s/config.hpp>
+#include <lo2s/error.hpp>
+#include <lo2s/local_cctx_tree.hpp>
+#include <lo2s/log.hpp>
+#include <lo2s/measurement_scope.hpp>
+#include <lo2s/monitor/bpf_monitor.hpp>
+#include <lo2s/perf/syscall/common.h>
+#include <lo2s/perf/syscall/histogram_writer.hpp>
+#include <lo2s/perf/time/converter.hpp>
+#include <lo2s/trace/budget.hpp>
+#include <lo2s/time/time.hpp>
+#include <lo2s/trace/trace.hpp>
+#include <lo2s/types/thread.hpp>
+
+#include <chrono>
+#include <memory>
+#include <utility>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <linux/bpf.h>
+#include <unistd.h>
+
+namespace lo2s::monitor
+{
+SyscallMonitor::SyscallMonitor(trace::Trace& trace, bool filter_threads)
+: BpfMonitor(trace, "syscall monitor", "syscall", "slow syscalls"), trace_(trace),
+  time_converter_(perf::time::Converter::instance())
+{
+    skel_ = decltype(skel_)(syscall_bpf__open());
+    if (!skel_)
+    {
+        Log::error() << "Could not open syscall BPF program";
+        throw_errno();
+    }
+
+    const auto& syscall_config = config().perf.syscall;
+
+    skel_->rodata->min_duration = syscall_config.threshold.count();
+    skel_->rodata->filter_pids = filter_threads;
+    skel_->rodata->filter_syscalls = !syscall_config.syscalls.empty();
+    skel_->rodata->lo2s_pid = getpid();
+    skel_->rodata->aggregate = syscall_config.histograms;
+
+    if (syscall_bpf__load(skel_.get()) < 0)
+    {
+        Log::error() << "Could not load syscall BPF program";
+        throw_errno();
+    }
+
+    for (auto syscall_nr : syscall_config.syscalls)
+    {
+        if (syscall_nr < 0 || syscall_nr >= MAX_SYSCALL_NR)
+        {
+            Log::warn() << "Can not record syscall " << syscall_nr << " with BPF, ignoring it";
+            continue;
+        }
+
+        uint32_t key = syscall_nr;
+        char enabled = 1;
+        bpf_map__update_elem(skel_->maps.syscalls, &key, sizeof(key), &enabled, sizeof(enabled),
+                             BPF_ANY);
+    }
+
+    if (syscall_bpf__attach(skel_.get()) < 0)
+    {
+        Log::error() << "Could not attach syscall BPF program to the raw_syscalls tracepoints";
+        throw_errno();
+    }
+
+    open_ring_buffer(skel_->maps.rb, skel_->maps.pids, skel_->maps.lost);
+}
+
+void SyscallMonitor::handle_event(void* data, size_t datasz [[maybe_unused]])
+{
+    auto* e = reinterpret_cast<struct syscall_event*>(data);
+
+    if (trace_.budget().degraded(trace::Degradation::DROPPING))
+    {
+        trace_.budget().drop();
+        return;
+    }
+
+    Thread const thread(e->pid);
+
+    auto it = local_cctx_trees_.find(thread);
+    if (it == local_cctx_trees_.end())
+    {
+        it = local_cctx_trees_
+                 .emplace(thread, &trace_.create_local_cctx_tree(
+                                      MeasurementScope::syscall(thread.as_scope())))
+                 .first;
+    }
+
+    // Syscalls of a thread are strictly sequential, and the ring buffer keeps the submission
+    // order, so the events of every thread are written in order.
+    auto& local_cctx_tree = *it->second;
+    local_cctx_tree.cctx_enter(time_converter_(e->enter_time), CCTX_LEVEL_SYSCALL,
+                               CallingContext::syscall(e->syscall_nr));
+    local_cctx_tree.cctx_leave(time_converter_(e->exit_time), CCTX_LEVEL_SYSCALL);
+
+    trace_.budget().account(2 * trace::Budget::EVENT_SIZE);
+}
+
+void SyscallMonitor::write_histograms()
+{
+    auto tp = lo2s::time::now();
+
+    struct syscall_stats_key key;
+    struct syscall_stats stats;
+    bool first = true;
+
+    // Entries of new threads or syscalls might be added while we iterate, but they are never
+    // deleted, except for the LRU evicting very old ones
+    while (bpf_map__get_next_key(skel_->maps.stats, first ? nullptr : &key, &key, sizeof(key)) ==
+           0)
+    {
+        first = false;
+
+        if (bpf_map__lookup_elem(skel_->maps.stats, &key, sizeof(key), &stats, sizeof(stats), 0) !=
+            0)
+        {
+            continue;
+        }
+
+        auto writer_key = std::make_pair(Thread(key.pid), static_cast<int64_t>(key.syscall_nr));
+        auto it = histogram_writers_.find(writer_key);
+        if (it == histogram_writers_.end())
+        {
+            it = histogram_writers_
+                     .emplace(writer_key, std::make_unique<perf::syscall::HistogramWriter>(
+                                              writer_key.first, writer_key.second, trace_))
+                     .first;
+        }
+        it->second->write(tp, stats);
+    }
+}
+
+void SyscallMonitor::monitor()
+{
+    const auto& syscall_config = config().perf.syscall;
+
+    if (syscall_config.histograms &&
+        std::chrono::steady_clock::now() - last_histograms_ >= syscall_config.histogram_interval)
+    {
+        write_histograms();
+        last_histograms_ = std::chrono::steady_clock::now();
+    }
+}
+
+void SyscallMonitor::finalize_thread()
+{
+    if (config().perf.syscall.histograms)
+    {
+        write_histograms();
+    }
+
+    for (auto& local_cctx_tree : local_cctx_trees_)
+    {
+        local_cctx_tree.second->finalize();
+    }
+}
+} // namespace lo2s::monitor
@@ -4,11 +4,15 @@
 
 #include <lo2s/monitor/threaded_monitor.hpp>
 
+#include <lo2s/config.hpp>
 #include <lo2s/log.hpp>
+#include <lo2s/monitor/overhead_recorder.hpp>
+#include <lo2s/stream/stream.hpp>
 #include <lo2s/summary.hpp>
 #include <lo2s/trace/trace.hpp>
 #include <lo2s/util.hpp>
 
+#include <memory>
 #include <string>
 #include <utility>
 
@@ -33,6 +37,12 @@ ThreadedMonitor::~ThreadedMonitor()
 void ThreadedMonitor::start()
 {
     assert(!thread_.joinable());
+
+    if (config().otf2.overhead_metrics)
+    {
+        overhead_ = std::make_unique<OverheadRecorder>(trace_, name());
+    }
+
     thread_ = std::thread([this]() { this->thread_main(); });
 }
 
@@ -53,6 +63,9 @@ void ThreadedMonitor::thread_main()
     run();
     Log::debug() << name() << " ending.";
     finalize_thread();
+
+    // Nothing may be left behind in the stream batches of the thread, see stream::Writer
+    trace_.stream().flush_all();
 }
 
 void ThreadedMonitor::register_thread()
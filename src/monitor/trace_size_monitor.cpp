@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <lo2s/monitor/trace_size_monitor.hpp>
+
+#include <lo2s/config.hpp>
+#include <lo2s/error.hpp>
+#include <lo2s/log.hpp>
+#include <lo2s/monitor/poll_monitor.hpp>
+#include <lo2s/summary.hpp>
+#include <lo2s/trace/trace.hpp>
+#include <lo2s/util.hpp>
+
+#include <cerrno>
+#include <cstdint>
+
+extern "C"
+{
+#include <unistd.h>
+}
+
+namespace lo2s::monitor
+{
+TraceSizeMonitor::TraceSizeMonitor(trace::Trace& trace)
+: PollMonitor(trace, "TraceSizeMonitor"),
+  timer_fd_(timerfd_from_ns(config().otf2.report_size_interval))
+{
+    add_fd(timer_fd_);
+}
+
+TraceSizeMonitor::~TraceSizeMonitor()
+{
+    close(timer_fd_);
+}
+
+void TraceSizeMonitor::monitor(int fd)
+{
+    if (fd != timer_fd_)
+    {
+        return;
+    }
+
+    [[maybe_unused]] uint64_t expirations = 0;
+    if (read(timer_fd_, &expirations, sizeof(expirations)) == -1 && errno != EAGAIN)
+    {
+        Log::error() << "Flushing timer fd failed";
+        throw_errno();
+    }
+
+    summary().report_trace_size();
+}
+} // namespace lo2s::monitor
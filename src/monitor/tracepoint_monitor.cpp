@@ -4,7 +4,9 @@
 
 #include <lo2s/monitor/tracepoint_monitor.hpp>
 
+#include <lo2s/config.hpp>
 #include <lo2s/monitor/poll_monitor.hpp>
+#include <lo2s/numa.hpp>
 #include <lo2s/perf/tracepoint/event_attr.hpp>
 #include <lo2s/perf/tracepoint/writer.hpp>
 #include <lo2s/trace/trace.hpp>
@@ -12,6 +14,7 @@
 #include <lo2s/util.hpp>
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <tuple>
 #include <utility>
@@ -26,6 +29,12 @@ TracepointMonitor::TracepointMonitor(trace::Trace& trace, Cpu cpu)
     const std::vector<perf::tracepoint::TracepointEventAttr> tracepoint_events =
         perf::EventComposer::instance().emplace_tracepoints();
 
+    std::optional<NumaPlacement> placement;
+    if (config().perf.numa_placement)
+    {
+        placement.emplace(numa_node_of_scope(cpu.as_scope()));
+    }
+
     for (const auto& event : tracepoint_events)
     {
         auto& mc = trace.tracepoint_metric_class(event);
@@ -42,6 +51,11 @@ TracepointMonitor::TracepointMonitor(trace::Trace& trace, Cpu cpu)
 void TracepointMonitor::initialize_thread()
 {
     try_pin_to_scope(cpu_.as_scope());
+
+    if (config().perf.numa_placement)
+    {
+        try_prefer_numa_node(numa_node_of_scope(cpu_.as_scope()));
+    }
 }
 
 void TracepointMonitor::monitor(int fd)
@@ -0,0 +1,195 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <lo2s/numa.hpp>
+
+#include <lo2s/error.hpp>
+#include <lo2s/execution_scope.hpp>
+#include <lo2s/log.hpp>
+#include <lo2s/topology.hpp>
+#include <lo2s/types/cpu.hpp>
+#include <lo2s/types/thread.hpp>
+
+#include <climits>
+#include <cstddef>
+
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace lo2s
+{
+namespace
+{
+// The kernel interprets maxnode as "number of bits plus one" (sic)
+constexpr unsigned long MAX_NODE_ARG = NumaPlacement::MAX_NODES + 1;
+
+// Direct system calls, so that lo2s does not need to link against libnuma
+long set_mempolicy(int mode, const NumaPlacement::NodeMask* nodes)
+{
+    return syscall(SYS_set_mempolicy, mode, nodes != nullptr ? nodes->data() : nullptr,
+                   nodes != nullptr ? MAX_NODE_ARG : 0);
+}
+
+long mbind(void* addr, std::size_t len, int mode, const NumaPlacement::NodeMask* nodes)
+{
+    return syscall(SYS_mbind, addr, len, mode, nodes->data(), MAX_NODE_ARG, 0);
+}
+
+long get_mempolicy(int* mode, NumaPlacement::NodeMask* nodes)
+{
+    return syscall(SYS_get_mempolicy, mode, nodes->data(), MAX_NODE_ARG, nullptr, 0);
+}
+
+NumaPlacement::NodeMask node_mask(int node)
+{
+    constexpr std::size_t bits = sizeof(unsigned long) * CHAR_BIT;
+
+    NumaPlacement::NodeMask mask = {};
+    mask[node / bits] |= 1UL << (node % bits);
+    return mask;
+}
+
+bool is_numa()
+{
+    return Topology::instance().numa_nodes().size() > 1;
+}
+} // namespace
+
+int numa_node_of_scope(ExecutionScope scope)
+{
+    if (!is_numa())
+    {
+        return -1;
+    }
+
+    const auto& topology = Topology::instance();
+    if (scope.is_cpu())
+    {
+        return topology.numa_node_of(scope.as_cpu());
+    }
+
+    cpu_set_t cpumask;
+    CPU_ZERO(&cpumask);
+    if (sched_getaffinity(static_cast<pid_t>(scope.as_thread().as_int()), sizeof(cpumask),
+                          &cpumask) != 0)
+    {
+        return -1;
+    }
+
+    int node = -1;
+    for (const auto& cpu : topology.cpus())
+    {
+        if (!CPU_ISSET(cpu.as_int(), &cpumask))
+        {
+            continue;
+        }
+
+        auto cpu_node = topology.numa_node_of(cpu);
+        if (cpu_node == -1 || (node != -1 && cpu_node != node))
+        {
+            return -1;
+        }
+        node = cpu_node;
+    }
+    return node;
+}
+
+void try_prefer_numa_node(int node)
+{
+    if (!is_numa() || node >= static_cast<int>(NumaPlacement::MAX_NODES))
+    {
+        return;
+    }
+
+    long ret = 0;
+    if (node == -1)
+    {
+        ret = set_mempolicy(MPOL_DEFAULT, nullptr);
+    }
+    else
+    {
+        auto mask = node_mask(node);
+        ret = set_mempolicy(MPOL_PREFERRED, &mask);
+    }
+
+    if (ret != 0)
+    {
+        Log::debug() << "set_mempolicy for NUMA node " << node
+                     << " failed with: " << make_system_error().what();
+    }
+}
+
+void try_prefer_numa_node(void* addr, std::size_t len, int node)
+{
+    if (!is_numa() || node < 0 || node >= static_cast<int>(NumaPlacement::MAX_NODES))
+    {
+        return;
+    }
+
+    auto mask = node_mask(node);
+    if (mbind(addr, len, MPOL_PREFERRED, &mask) != 0)
+    {
+        Log::debug() << "mbind for NUMA node " << node
+                     << " failed with: " << make_system_error().what();
+    }
+}
+
+NumaPlacement::NumaPlacement(int node)
+{
+    if (!is_numa() || node < 0 || node >= static_cast<int>(MAX_NODES))
+    {
+        return;
+    }
+
+    CPU_ZERO(&saved_affinity_);
+    if (sched_getaffinity(0, sizeof(saved_affinity_), &saved_affinity_) != 0 ||
+        get_mempolicy(&saved_mode_, &saved_nodes_) != 0)
+    {
+        Log::debug() << "Can not save placement of the current thread: "
+                     << make_system_error().what();
+        return;
+    }
+
+    cpu_set_t cpumask;
+    CPU_ZERO(&cpumask);
+    for (const auto& cpu : Topology::instance().cpus_of_numa_node(node))
+    {
+        CPU_SET(cpu.as_int(), &cpumask);
+    }
+
+    // Might fail if we are confined to other nodes (cpusets), the memory policy still applies
+    if (sched_setaffinity(0, sizeof(cpumask), &cpumask) != 0)
+    {
+        Log::debug() << "Can not move to the CPUs of NUMA node " << node << ": "
+                     << make_system_error().what();
+    }
+
+    auto mask = node_mask(node);
+    if (set_mempolicy(MPOL_PREFERRED, &mask) != 0)
+    {
+        Log::debug() << "set_mempolicy for NUMA node " << node
+                     << " failed with: " << make_system_error().what();
+    }
+    active_ = true;
+}
+
+NumaPlacement::~NumaPlacement()
+{
+    if (!active_)
+    {
+        return;
+    }
+
+    if (set_mempolicy(saved_mode_, saved_mode_ == MPOL_DEFAULT ? nullptr : &saved_nodes_) != 0)
+    {
+        Log::warn() << "Can not restore the memory policy: " << make_system_error().what();
+    }
+    if (sched_setaffinity(0, sizeof(saved_affinity_), &saved_affinity_) != 0)
+    {
+        Log::warn() << "Can not restore the CPU affinity: " << make_system_error().what();
+    }
+}
+} // namespace lo2s
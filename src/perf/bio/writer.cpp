@@ -7,6 +7,9 @@
 #include <lo2s/perf/bio/block_device.hpp>
 #include <lo2s/perf/io_reader.hpp>
 #include <lo2s/perf/time/converter.hpp>
+#include <lo2s/stream/format.hpp>
+#include <lo2s/stream/stream.hpp>
+#include <lo2s/trace/budget.hpp>
 #include <lo2s/trace/trace.hpp>
 
 #include <otf2xx/common.hpp>
@@ -18,7 +21,9 @@
 
 namespace lo2s::perf::bio
 {
-Writer::Writer(trace::Trace& trace) : trace_(trace), time_converter_(time::Converter::instance())
+Writer::Writer(trace::Trace& trace)
+: trace_(trace), time_converter_(time::Converter::instance()),
+  stream_(trace.stream(), stream::SourceType::IO, "block I/O")
 {
 }
 
@@ -43,6 +48,14 @@ void Writer::write(IoReaderIdentity& identity, TracepointSampleType* header)
             return;
         }
 
+        // Only drop whole operations, issue and complete are skipped because the sector is not
+        // in the sector_cache_
+        if (trace_.budget().degraded(trace::Degradation::DROPPING))
+        {
+            trace_.budget().drop();
+            return;
+        }
+
         const BlockDevice dev = block_device_for<RecordBioQueue>(event);
 
         otf2::writer::local& writer = trace_.bio_writer(dev);
@@ -53,6 +66,9 @@ void Writer::write(IoReaderIdentity& identity, TracepointSampleType* header)
         writer << otf2::event::io_operation_begin(
             time_converter_(event->header.time), handle, mode,
             otf2::common::io_operation_flag_type::non_blocking, size, event->sector);
+        stream_.io(stream::RecordType::IO_BEGIN, time_converter_(event->header.time), handle.ref(),
+                   static_cast<uint64_t>(mode), size, event->sector);
+        trace_.budget().account(trace::Budget::EVENT_SIZE);
     }
     else if (identity.tracepoint() == bio_issue_)
     {
@@ -70,6 +86,7 @@ void Writer::write(IoReaderIdentity& identity, TracepointSampleType* header)
 
         writer << otf2::event::io_operation_issued(time_converter_(event->header.time), handle,
                                                    event->sector);
+        trace_.budget().account(trace::Budget::EVENT_SIZE);
     }
     else if (identity.tracepoint() == bio_complete_)
     {
@@ -77,7 +94,7 @@ void Writer::write(IoReaderIdentity& identity, TracepointSampleType* header)
 
         const BlockDevice dev = block_device_for<RecordBlock>(event);
 
-        if (sector_cache_.count(dev) == 0 && sector_cache_[dev].count(event->sector) == 0)
+        if (sector_cache_.count(dev) == 0 || sector_cache_.at(dev).count(event->sector) == 0)
         {
             return;
         }
@@ -88,7 +105,10 @@ void Writer::write(IoReaderIdentity& identity, TracepointSampleType* header)
         writer << otf2::event::io_operation_complete(time_converter_(event->header.time), handle,
                                                      sector_cache_[dev][event->sector],
                                                      event->sector);
-        sector_cache_[dev][event->sector] = 0;
+        stream_.io(stream::RecordType::IO_COMPLETE, time_converter_(event->header.time),
+                   handle.ref(), 0, sector_cache_[dev][event->sector], event->sector);
+        sector_cache_.at(dev).erase(event->sector);
+        trace_.budget().account(trace::Budget::EVENT_SIZE);
     }
     else
     {
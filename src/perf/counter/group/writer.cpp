@@ -8,10 +8,11 @@
 #include <lo2s/measurement_scope.hpp>
 #include <lo2s/perf/counter/group/reader.hpp>
 #include <lo2s/perf/counter/metric_writer.hpp>
+#include <lo2s/time/time.hpp>
 #include <lo2s/trace/trace.hpp>
 
-#include <cassert>
 #include <cstddef>
+#include <cstdint>
 
 namespace lo2s::perf::counter::group
 {
@@ -27,22 +28,59 @@ bool Writer::handle(const Reader::RecordSampleType* sample)
 
     counter_buffer_.read(&sample->v);
 
-    otf2::event::metric::values& values = metric_event_.raw_values();
-
-    assert(counter_buffer_.size() <= values.size());
+    counter_values_.resize(counter_buffer_.size());
+    time_values_.resize(2);
 
     // read counter values into metric event
     for (std::size_t i = 0; i < counter_buffer_.size(); i++)
     {
-        values[i] = counter_buffer_[i] * counter_collection_.get_scale(i);
+        counter_values_[i] = counter_buffer_[i] * counter_collection_.get_scale(i);
     }
 
-    auto index = counter_buffer_.size();
-    values[index++] = counter_buffer_.enabled();
-    values[index++] = counter_buffer_.running();
+    time_values_[0] = counter_buffer_.enabled();
+    time_values_[1] = counter_buffer_.running();
 
-    writer_.write(metric_event_);
+    write_counter_event();
     return false;
 }
 
+void Writer::handle_rotation(std::size_t active_group)
+{
+    metric_event_.timestamp(lo2s::time::now());
+
+    counter_values_.assign(counter_collection_.counters.size() + 1, 0);
+    time_values_.assign(2, 0);
+
+    // Exactly one leader copy is enabled at any time, so together they cover the whole measurement
+    for (auto& group : rotation_groups_)
+    {
+        counter_values_[0] += group.buffer[0] * counter_collection_.get_scale(0);
+        for (std::size_t i = 1; i <= group.size; i++)
+        {
+            counter_values_[group.first + i] =
+                group.buffer[i] * counter_collection_.get_scale(group.first + i);
+        }
+
+        time_values_[0] += group.buffer.enabled();
+        time_values_[1] += group.buffer.running();
+    }
+
+    // Share of the measurement in which the counters of the active group were counting
+    const uint64_t running = rotation_groups_[active_group].buffer.running();
+    point_values_ = { static_cast<double>(active_group),
+                      time_values_[0] == 0 ? 0 : 100.0 * running / time_values_[0] };
+
+    write_counter_event();
+}
+
+void Writer::end()
+{
+    // Otherwise, what the active group counted since the last rotation would be lost
+    if (rotation_timer_fd_ != -1)
+    {
+        rotate();
+    }
+    write_last_counter_event();
+}
+
 } // namespace lo2s::perf::counter::group
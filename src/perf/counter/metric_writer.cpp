@@ -4,10 +4,20 @@
 
 #include <lo2s/perf/counter/metric_writer.hpp>
 
+#include <lo2s/config.hpp>
 #include <lo2s/measurement_scope.hpp>
+#include <lo2s/stream/format.hpp>
+#include <lo2s/stream/stream.hpp>
+#include <lo2s/trace/budget.hpp>
 #include <lo2s/trace/trace.hpp>
 
 #include <otf2xx/chrono/time_point.hpp>
+#include <otf2xx/event/metric.hpp>
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 
 namespace lo2s::perf::counter
 {
@@ -16,7 +26,116 @@ MetricWriter::MetricWriter(MeasurementScope scope, trace::Trace& trace)
   metric_instance_(
       trace.metric_instance(trace.perf_metric_class(scope), writer_.location(),
                             trace.sample_writer(MeasurementScope::sample(scope.scope)).location())),
-  metric_event_(otf2::chrono::genesis(), metric_instance_)
+  metric_event_(otf2::chrono::genesis(), metric_instance_), budget_(trace.budget()),
+  stream_(trace.stream(), stream::SourceType::METRIC, scope.name())
+{
+}
+
+MetricWriter::MetricWriter(MeasurementScope scope, trace::Trace& trace,
+                           const otf2::definition::metric_class& metric_class)
+: time_converter_(time::Converter::instance()), writer_(trace.metric_writer(scope)),
+  // The metric location is the only one these metrics are guaranteed to have, there is no sample
+  // location for every thread e.g. in system mode
+  metric_instance_(trace.metric_instance(metric_class, writer_.location(), writer_.location())),
+  metric_event_(otf2::chrono::genesis(), metric_instance_), budget_(trace.budget()),
+  stream_(trace.stream(), stream::SourceType::METRIC, scope.name())
+{
+}
+
+bool MetricWriter::write_metric_event()
+{
+    // The counters are accumulated, so skipping events only reduces the temporal resolution
+    if (budget_.degraded(trace::Degradation::DROPPING) ||
+        (budget_.degraded(trace::Degradation::DECIMATED_METRICS) &&
+         num_events_++ % trace::Budget::DECIMATION_FACTOR != 0))
+    {
+        budget_.drop();
+        return false;
+    }
+
+    writer_.write(metric_event_);
+    stream_.metric(metric_event_);
+    budget_.account_metric(metric_event_.raw_values().size());
+    return true;
+}
+
+void MetricWriter::write_counter_event()
+{
+    otf2::event::metric::values& values = metric_event_.raw_values();
+
+    assert(counter_values_.size() + time_values_.size() + point_values_.size() <= values.size());
+
+    if (!config().perf.metric_deltas)
+    {
+        std::size_t index = 0;
+        for (auto value : counter_values_)
+        {
+            values[index++] = value;
+        }
+        for (auto value : time_values_)
+        {
+            values[index++] = value;
+        }
+        for (auto value : point_values_)
+        {
+            values[index++] = value;
+        }
+        write_metric_event();
+        return;
+    }
+
+    last_counter_values_.resize(counter_values_.size(), 0);
+    last_time_values_.resize(time_values_.size(), 0);
+
+    bool changed = false;
+    for (std::size_t i = 0; i < counter_values_.size(); i++)
+    {
+        changed |= std::abs(counter_values_[i] - last_counter_values_[i]) >
+                   config().perf.metric_delta_threshold;
+    }
+    if (!changed)
+    {
+        left_out_ = true;
+        return;
+    }
+
+    write_counter_deltas();
+}
+
+void MetricWriter::write_counter_deltas()
+{
+    otf2::event::metric::values& values = metric_event_.raw_values();
+
+    // The differences are always to the last written event, so that the values of left out or
+    // dropped events are contained in the next written one
+    std::size_t index = 0;
+    for (std::size_t i = 0; i < counter_values_.size(); i++)
+    {
+        values[index++] = counter_values_[i] - last_counter_values_[i];
+    }
+    for (std::size_t i = 0; i < time_values_.size(); i++)
+    {
+        values[index++] = time_values_[i] - last_time_values_[i];
+    }
+    for (auto value : point_values_)
+    {
+        values[index++] = value;
+    }
+
+    left_out_ = !write_metric_event();
+    if (!left_out_)
+    {
+        last_counter_values_ = counter_values_;
+        last_time_values_ = time_values_;
+    }
+}
+
+void MetricWriter::write_last_counter_event()
 {
+    // The changes below the threshold since the last written event would be lost otherwise
+    if (config().perf.metric_deltas && left_out_)
+    {
+        write_counter_deltas();
+    }
 }
 } // namespace lo2s::perf::counter
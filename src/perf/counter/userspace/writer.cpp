@@ -14,7 +14,6 @@
 
 #include <vector>
 
-#include <cassert>
 #include <cstddef>
 
 namespace lo2s::perf::counter::userspace
@@ -31,9 +30,7 @@ bool Writer::handle(std::vector<UserspaceReadFormat>& data)
 
     counter_buffer_.read(data);
 
-    otf2::event::metric::values& values = metric_event_.raw_values();
-
-    assert(counter_buffer_.size() <= values.size());
+    counter_values_.resize(counter_buffer_.size());
 
     // read counter values into metric event
 
@@ -41,11 +38,16 @@ bool Writer::handle(std::vector<UserspaceReadFormat>& data)
     {
         // In get_scale, index 0 is reserved for the metric leader, which we don't have in the
         // userspace metric mode, so add 1 to the counter index
-        values[i] = counter_buffer_[i] * counter_collection_.get_scale(i + 1);
+        counter_values_[i] = counter_buffer_[i] * counter_collection_.get_scale(i + 1);
     }
 
-    writer_.write(metric_event_);
+    write_counter_event();
     return false;
 }
 
+void Writer::end()
+{
+    write_last_counter_event();
+}
+
 } // namespace lo2s::perf::counter::userspace
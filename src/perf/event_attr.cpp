@@ -8,6 +8,7 @@
 #include <lo2s/error.hpp>
 #include <lo2s/execution_scope.hpp>
 #include <lo2s/log.hpp>
+#include <lo2s/perf/event_handover.hpp>
 #include <lo2s/perf/util.hpp>
 #include <lo2s/topology.hpp>
 #include <lo2s/types/cpu.hpp>
@@ -720,6 +721,14 @@ EventGuard::EventGuard(EventAttr& ev, std::variant<Cpu, Thread> location, int gr
     Log::trace() << "Opening perf event: " << ev.name() << "[" << scope.name()
                  << ", group fd: " << group_fd << ", cgroup fd: " << cgroup_fd << "]";
     Log::trace() << ev;
+
+    fd_ = EventHandover::instance().claim(ev.attr(), scope, group_fd, cgroup_fd);
+    if (fd_ != -1)
+    {
+        Log::trace() << "Took over perf event from the previous trace! fd: " << fd_;
+        return;
+    }
+
     fd_ = perf_event_open(&ev.attr(), scope, group_fd, 0, cgroup_fd);
 
     if (fd_ < 0)
@@ -734,6 +743,8 @@ EventGuard::EventGuard(EventAttr& ev, std::variant<Cpu, Thread> location, int gr
         throw_errno();
     }
     Log::trace() << "SuccesfULLy opened perf event! fd: " << fd_;
+
+    EventHandover::instance().opened(fd_, ev.attr(), scope, group_fd, cgroup_fd);
 }
 
 void EventGuard::enable() const
@@ -760,6 +771,14 @@ void EventGuard::set_output(const EventGuard& other_ev) const
     }
 }
 
+void EventGuard::set_sample_period(uint64_t period) const
+{
+    if (ioctl(fd_, PERF_EVENT_IOC_PERIOD, &period) == -1)
+    {
+        throw_errno();
+    }
+}
+
 void EventGuard::set_syscall_filter(const std::vector<int64_t>& syscall_filter) const
 {
     if (syscall_filter.empty())
@@ -5,6 +5,7 @@
 #include <lo2s/perf/event_composer.hpp>
 
 #include <lo2s/config.hpp>
+#include <lo2s/dwarf_unwind.hpp>
 #include <lo2s/execution_scope.hpp>
 #include <lo2s/log.hpp>
 #include <lo2s/measurement_scope.hpp>
@@ -12,12 +13,16 @@
 #include <lo2s/perf/event_attr.hpp>
 #include <lo2s/perf/event_resolver.hpp>
 #include <lo2s/perf/tracepoint/event_attr.hpp>
+#include <lo2s/topology.hpp>
 #include <lo2s/types/thread.hpp>
 
 #include <optional>
+#include <set>
+#include <system_error>
 #include <vector>
 
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 
 #include <linux/hw_breakpoint.h>
@@ -101,11 +106,34 @@ EventAttr EventComposer::create_sampling_event()
     // TODO see if we can remove remove tid
     res.set_sample_type(PERF_SAMPLE_TIME | PERF_SAMPLE_IP | PERF_SAMPLE_TID | PERF_SAMPLE_CPU);
 
-    if (config().perf.sampling.enable_callgraph)
+    if (config().perf.sampling.dwarf_unwinding)
+    {
+        // The user space call stack is unwound by lo2s from the registers and the stack snapshot
+        res.set_sample_type(PERF_SAMPLE_REGS_USER | PERF_SAMPLE_STACK_USER);
+        res.set_sample_regs_user(DwarfUnwinder::sample_regs_user());
+        res.set_sample_stack_user(config().perf.sampling.unwind_stack_size);
+    }
+    else if (config().perf.sampling.enable_callgraph)
     {
         res.set_sample_type(PERF_SAMPLE_CALLCHAIN);
     }
 
+    if (!config().perf.sampling.counters.empty())
+    {
+        // The sampling event leads a group of the --sample-counter events, which are read with
+        // every sample
+        res.set_sample_type(PERF_SAMPLE_READ);
+        res.set_read_format(PERF_FORMAT_GROUP);
+    }
+
+    if (config().perf.sampling.memory_sampling)
+    {
+        // Events that do not support data sources or latencies report 0 for them
+        res.set_sample_type(PERF_SAMPLE_ADDR | PERF_SAMPLE_WEIGHT | PERF_SAMPLE_DATA_SRC);
+        // Data addresses are resolved against all mappings, not only the executable ones
+        res.set_mmap_data();
+    }
+
     if (config().perf.sampling.enabled)
     {
         set_precision(res);
@@ -115,6 +143,21 @@ EventAttr EventComposer::create_sampling_event()
     return sampling_event_.value();
 }
 
+std::vector<EventAttr> EventComposer::create_sample_counters()
+{
+    std::vector<EventAttr> res;
+    for (const auto& name : config().perf.sampling.counters)
+    {
+        res.emplace_back(EventResolver::instance().get_event_by_name(name));
+
+        if (exclude_kernel_)
+        {
+            res.back().set_exclude_kernel();
+        }
+    }
+    return res;
+}
+
 EventAttr EventComposer::create_time_event(uint64_t local_time [[maybe_unused]])
 
 {
@@ -259,9 +302,104 @@ void EventComposer::emplace_group_counters()
         }
     }
 
+    if (config().perf.group.use_frequency)
+    {
+        res.group_starts = partition_group_counters(res);
+        if (!res.group_starts.empty())
+        {
+            Log::info() << "The requested metric events do not fit into a single group, counting "
+                        << res.group_starts.size() + 1 << " groups in turn, switching every "
+                        << 1000.0 / config().perf.group.frequency << " ms";
+        }
+    }
+    else if (!partition_group_counters(res).empty())
+    {
+        Log::warn() << "The requested metric events do not fit into a single group with "
+                       "--metric-leader, the kernel will multiplex them. Use --metric-frequency "
+                       "to count them in separate groups instead.";
+    }
+
     group_counters_ = res;
 }
 
+// Greedily splits the counters into groups that the PMU can schedule at once, by opening them as
+// members of the leader until that fails. Opening a member fails if the group can never be
+// scheduled on its own, so this does not depend on what else is counting at the moment.
+//
+// Hybrid systems have different PMUs on different CPUs, so this is done on every CPU and a group
+// is split wherever it does not fit on any of them.
+std::vector<std::size_t>
+EventComposer::partition_group_counters(counter::CounterCollection& collection)
+{
+    std::vector<ExecutionScope> probe_scopes;
+    for (const auto& cpu : Topology::instance().cpus())
+    {
+        if (collection.leader->is_available_in(cpu.as_scope()) &&
+            collection.leader->can_open(cpu.as_scope()))
+        {
+            probe_scopes.emplace_back(cpu.as_scope());
+        }
+    }
+    // Without permission for system-wide monitoring, the PMU of the CPU lo2s runs on has to do
+    if (probe_scopes.empty())
+    {
+        if (!collection.leader->can_open(Thread(0).as_scope()))
+        {
+            return {};
+        }
+        probe_scopes.emplace_back(Thread(0).as_scope());
+    }
+
+    std::set<std::size_t> starts;
+    for (const auto& scope : probe_scopes)
+    {
+        std::optional<EventGuard> leader;
+        std::vector<EventGuard> members;
+
+        for (std::size_t i = 0; i < collection.counters.size(); i++)
+        {
+            auto& counter = collection.counters[i];
+            if (!counter.is_available_in(scope))
+            {
+                continue;
+            }
+
+            if (!leader.has_value() || starts.count(i) != 0)
+            {
+                members.clear();
+                leader = collection.leader->open(scope);
+            }
+
+            try
+            {
+                members.emplace_back(leader->open_child(counter, scope));
+            }
+            catch (const std::system_error&)
+            {
+                // Does not even fit into a group on its own, nothing to gain from splitting
+                if (members.empty())
+                {
+                    continue;
+                }
+
+                starts.emplace(i);
+                members.clear();
+                leader = collection.leader->open(scope);
+
+                try
+                {
+                    members.emplace_back(leader->open_child(counter, scope));
+                }
+                catch (const std::system_error&)
+                {
+                }
+            }
+        }
+    }
+
+    return { starts.begin(), starts.end() };
+}
+
 bool EventComposer::has_counters_for(MeasurementScope scope)
 {
     return !counters_for(scope).counters.empty();
@@ -293,10 +431,26 @@ counter::CounterCollection EventComposer::group_counters_for(ExecutionScope scop
     {
         res.leader = group_counters.leader.value();
 
-        for (auto& ev : group_counters.counters)
+        // Keep the group boundaries in place for the counters that remain
+        auto group_start = group_counters.group_starts.begin();
+        bool starts_group = false;
+        for (std::size_t i = 0; i < group_counters.counters.size(); i++)
         {
+            auto& ev = group_counters.counters[i];
+
+            if (group_start != group_counters.group_starts.end() && *group_start == i)
+            {
+                starts_group = true;
+                group_start++;
+            }
+
             if (ev.is_available_in(scope))
             {
+                if (starts_group && !res.counters.empty())
+                {
+                    res.group_starts.emplace_back(res.counters.size());
+                }
+                starts_group = false;
                 res.counters.emplace_back(ev);
             }
             else
@@ -0,0 +1,158 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <lo2s/perf/event_handover.hpp>
+
+#include <lo2s/config.hpp>
+#include <lo2s/execution_scope.hpp>
+#include <lo2s/log.hpp>
+#include <lo2s/shared_memory.hpp>
+
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include <cstddef>
+
+extern "C"
+{
+#include <linux/perf_event.h>
+#include <unistd.h>
+}
+
+namespace lo2s::perf
+{
+EventHandover::EventHandover()
+: enabled_(config().otf2.rotate_interval.count() != 0 || config().otf2.rotate_size != 0)
+{
+}
+
+EventHandover::~EventHandover()
+{
+    end();
+}
+
+void EventHandover::begin()
+{
+    const std::lock_guard<std::mutex> lock(mutex_);
+    active_ = enabled_;
+}
+
+void EventHandover::end()
+{
+    const std::lock_guard<std::mutex> lock(mutex_);
+    active_ = false;
+
+    if (!parked_.empty())
+    {
+        Log::debug() << "Closing " << parked_.size() << " perf events not used by the new trace";
+    }
+
+    mappings_.clear();
+    for (const auto& event : parked_)
+    {
+        events_.erase(event.second);
+        close(event.second);
+    }
+    parked_.clear();
+}
+
+int EventHandover::claim(const perf_event_attr& attr, ExecutionScope scope, int group_fd,
+                         int cgroup_fd)
+{
+    if (!enabled_)
+    {
+        return -1;
+    }
+
+    const std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = parked_.find(Key{ attr, scope, group_fd, cgroup_fd });
+    if (it == parked_.end())
+    {
+        return -1;
+    }
+
+    int const fd = it->second;
+    parked_.erase(it);
+    return fd;
+}
+
+void EventHandover::opened(int fd, const perf_event_attr& attr, ExecutionScope scope,
+                           int group_fd, int cgroup_fd)
+{
+    if (!enabled_)
+    {
+        return;
+    }
+
+    const std::lock_guard<std::mutex> lock(mutex_);
+    events_.insert_or_assign(fd, Key{ attr, scope, group_fd, cgroup_fd });
+}
+
+bool EventHandover::park(int fd)
+{
+    if (!enabled_)
+    {
+        return false;
+    }
+
+    const std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = events_.find(fd);
+    if (it == events_.end())
+    {
+        return false;
+    }
+
+    if (!active_)
+    {
+        events_.erase(it);
+        return false;
+    }
+
+    parked_.emplace(it->second, fd);
+    return true;
+}
+
+std::optional<SharedMemory> EventHandover::claim_mapping(int fd, std::size_t size)
+{
+    if (!enabled_)
+    {
+        return std::nullopt;
+    }
+
+    const std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = mappings_.find(fd);
+    if (it == mappings_.end() || it->second.size() != size)
+    {
+        return std::nullopt;
+    }
+
+    std::optional<SharedMemory> mapping(std::move(it->second));
+    mappings_.erase(it);
+    return mapping;
+}
+
+void EventHandover::park_mapping(int fd, SharedMemory& mapping)
+{
+    if (!enabled_)
+    {
+        return;
+    }
+
+    const std::lock_guard<std::mutex> lock(mutex_);
+
+    // Only keep the ring buffers of parked events
+    for (const auto& event : parked_)
+    {
+        if (event.second == fd)
+        {
+            mappings_.insert_or_assign(fd, std::move(mapping));
+            return;
+        }
+    }
+}
+} // namespace lo2s::perf
@@ -0,0 +1,147 @@
+/*
+ * SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// The generated vmlinux.h headers has to go first
+// clang-format off
+#include <vmlinux.h>
+// clang-format on
+
+#include <lo2s/perf/off_cpu/common.h>
+
+#include <bpf/bpf_helpers.h>
+
+// Is needed to load BPF programs into the kernel
+char LICENSE[] SEC("license") = "GPL";
+
+// Set by lo2s before the program is loaded
+// Minimum duration of a blocked interval to be submitted
+const volatile u64 min_duration = 0;
+// Only record the threads in the pids map, otherwise all threads but the ones of lo2s
+const volatile bool filter_pids = false;
+// Process id of lo2s, so that lo2s itself is not recorded
+const volatile u32 lo2s_pid = 0;
+// Do not record the kernel part of the callchains
+const volatile bool exclude_kernel = false;
+
+// ring buffer for writing events to lo2s
+struct
+{
+    __uint(type, BPF_MAP_TYPE_RINGBUF);
+    __uint(max_entries, 1024 * 1024);
+} rb SEC(".maps");
+
+// Threads that are currently blocked, from sched_switch out until they are scheduled in again.
+// The callchains are too large for the BPF stack, so they are captured into the map entry
+// directly. LRU, as threads can exit while blocked.
+struct
+{
+    __uint(type, BPF_MAP_TYPE_LRU_HASH);
+    __uint(max_entries, 64 * 1024);
+    __type(key, u32);
+    __type(value, struct off_cpu_event);
+} blocked SEC(".maps");
+
+// A single, all zero entry to initialize the entries of blocked with, as a struct off_cpu_event
+// does not fit onto the BPF stack
+struct
+{
+    __uint(type, BPF_MAP_TYPE_ARRAY);
+    __uint(max_entries, 1);
+    __type(key, u32);
+    __type(value, struct off_cpu_event);
+} empty SEC(".maps");
+
+// map containing the threads to record, written from lo2s, read from BPF
+struct
+{
+    __uint(type, BPF_MAP_TYPE_LRU_HASH);
+    __uint(max_entries, 256 * 1024);
+    __type(key, u32);
+    __type(value, char);
+} pids SEC(".maps");
+
+// Number of blocked intervals that did not fit into the ring buffer
+struct
+{
+    __uint(type, BPF_MAP_TYPE_ARRAY);
+    __uint(max_entries, 1);
+    __type(key, u32);
+    __type(value, u64);
+} lost SEC(".maps");
+
+static __always_inline bool record_thread(u32 pid, u32 tgid)
+{
+    if (filter_pids)
+    {
+        return bpf_map_lookup_elem(&pids, &pid) != 0;
+    }
+    // Also skip the idle task
+    return pid != 0 && tgid != lo2s_pid;
+}
+
+SEC("tp/sched/sched_switch")
+
+int handle_sched_switch(struct trace_event_raw_sched_switch* ctx)
+{
+    u64 now = bpf_ktime_get_ns();
+    u64 pid_tgid = bpf_get_current_pid_tgid();
+    u32 prev_pid = pid_tgid;
+    u32 next_pid = ctx->next_pid;
+
+    // The tracepoint fires in the context of the previous task, so its callchains can be captured
+    // here. Only record threads that block, i.e. that sleep (TASK_INTERRUPTIBLE or
+    // TASK_UNINTERRUPTIBLE) and are not merely preempted.
+    if ((ctx->prev_state & 0x3) != 0 && record_thread(prev_pid, pid_tgid >> 32))
+    {
+        struct off_cpu_event* e = bpf_map_lookup_elem(&blocked, &prev_pid);
+        if (e == 0)
+        {
+            u32 key = 0;
+            struct off_cpu_event* zero = bpf_map_lookup_elem(&empty, &key);
+            if (zero != 0)
+            {
+                bpf_map_update_elem(&blocked, &prev_pid, zero, BPF_ANY);
+                e = bpf_map_lookup_elem(&blocked, &prev_pid);
+            }
+        }
+
+        if (e != 0)
+        {
+            e->pid = pid_tgid >> 32;
+            e->tid = prev_pid;
+            e->start_time = now;
+
+            long size = 0;
+            if (!exclude_kernel)
+            {
+                size = bpf_get_stack(ctx, e->kernel_ips, sizeof(e->kernel_ips), 0);
+            }
+            e->num_kernel_ips = size > 0 ? size / sizeof(u64) : 0;
+
+            size = bpf_get_stack(ctx, e->user_ips, sizeof(e->user_ips), BPF_F_USER_STACK);
+            e->num_user_ips = size > 0 ? size / sizeof(u64) : 0;
+        }
+    }
+
+    struct off_cpu_event* e = bpf_map_lookup_elem(&blocked, &next_pid);
+    if (e == 0)
+        return 0;
+
+    if (now - e->start_time >= min_duration)
+    {
+        e->end_time = now;
+        if (bpf_ringbuf_output(&rb, e, sizeof(*e), 0) != 0)
+        {
+            u32 key = 0;
+            u64* count = bpf_map_lookup_elem(&lost, &key);
+            if (count)
+                __sync_fetch_and_add(count, 1);
+        }
+    }
+
+    bpf_map_delete_elem(&blocked, &next_pid);
+    return 0;
+}
@@ -6,6 +6,9 @@
 
 #include <lo2s/address.hpp>
 #include <lo2s/calling_context.hpp>
+#include <lo2s/config.hpp>
+#include <lo2s/data_object.hpp>
+#include <lo2s/dwarf_unwind.hpp>
 #include <lo2s/execution_scope.hpp>
 #include <lo2s/function_resolver.hpp>
 #include <lo2s/log.hpp>
@@ -15,17 +18,24 @@
 #include <lo2s/resolvers.hpp>
 #include <lo2s/summary.hpp>
 #include <lo2s/time/time.hpp>
+#include <lo2s/trace/budget.hpp>
 #include <lo2s/trace/trace.hpp>
 #include <lo2s/types/process.hpp>
 #include <lo2s/types/thread.hpp>
+#include <lo2s/util.hpp>
 
 #include <otf2xx/chrono/time_point.hpp>
 #include <otf2xx/exception.hpp>
 
+#include <algorithm>
+#include <chrono>
 #include <exception>
 #include <map>
+#include <system_error>
 
 #include <cassert>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
 
 extern "C"
@@ -43,15 +53,30 @@ Writer::Writer(ExecutionScope scope, trace::Trace& trace, bool enable_on_exec)
                       trace.metric_instance(trace.cpuid_metric_class(),
                                             local_cctx_tree_.writer().location(),
                                             local_cctx_tree_.writer().location())),
-  time_converter_(perf::time::Converter::instance()), first_time_point_(lo2s::time::now()),
-  last_time_point_(first_time_point_)
+  sampling_period_event_(otf2::chrono::genesis(),
+                         trace.metric_instance(trace.sampling_period_metric_class(),
+                                               local_cctx_tree_.writer().location(),
+                                               local_cctx_tree_.writer().location())),
+  time_converter_(perf::time::Converter::instance()), period_(config().perf.sampling.period),
+  current_period_(period_), adapt_window_start_(lo2s::time::now()),
+  first_time_point_(adapt_window_start_), last_time_point_(first_time_point_),
+  last_sample_counters_(sample_counters_.size(), 0)
 {
+    if (config().perf.sampling.dwarf_unwinding)
+    {
+        unwinder_ = &DwarfUnwinder::instance();
+    }
+    if (config().perf.sampling.memory_sampling)
+    {
+        data_objects_ = &DataObjectResolver::instance();
+    }
 }
 
 Writer::~Writer()
 {
     try
     {
+        handle_pending_samples();
         local_cctx_tree_.cctx_leave(last_time_point_, CCTX_LEVEL_PROCESS);
     }
     catch (otf2::exception& e)
@@ -89,25 +114,306 @@ void Writer::emplace_resolvers(Resolvers& resolvers)
 }
 
 bool Writer::handle(const Reader::RecordSampleType* sample)
+{
+    if (unwinder_ == nullptr)
+    {
+        handle_sample(sample);
+        return false;
+    }
+
+    // Unwinding takes much longer than reading the sample, so only copy the sample out of the
+    // ring buffer while it is read and unwind it once the ring buffer is empty, to not make the
+    // kernel run out of space for the next samples
+    const auto* record = reinterpret_cast<const std::byte*>(sample);
+    pending_samples_.insert(pending_samples_.end(), record, record + sample->header.size);
+
+    // Do not hold more than a ring buffer worth of samples if the samples keep coming in faster
+    // than they are read
+    if (pending_samples_.size() >= mmap_pages_ * get_page_size())
+    {
+        handle_pending_samples();
+    }
+    return false;
+}
+
+void Writer::read_done()
+{
+    handle_pending_samples();
+}
+
+void Writer::handle_pending_samples()
+{
+    for (std::size_t offset = 0; offset < pending_samples_.size();)
+    {
+        const auto* sample =
+            reinterpret_cast<const Reader::RecordSampleType*>(pending_samples_.data() + offset);
+        handle_sample(sample);
+        offset += sample->header.size;
+    }
+    pending_samples_.clear();
+}
+
+void Writer::handle_sample(const Reader::RecordSampleType* sample)
 {
     auto tp = time_converter_(sample->time);
     tp = adjust_timepoints(tp);
 
     update_calling_context(Process(sample->pid), Thread(sample->tid), tp, false);
 
-    if (!record_callgraph_)
+    adjust_sampling_period(tp);
+
+    // The rest of the sample depends on the sample type, in this order:
+    // - addr, the data address with --memory-sampling, before cpu and res
+    // - { nr; values[nr] } of the group read with --sample-counter, the first value is the
+    //   sampling event itself
+    // - { nr; ips[nr] } of the callchain with --call-graph
+    // - { abi; regs[]; size; data[size]; dyn_size } of the registers and the stack with
+    //   --dwarf-unwinding
+    // - weight and data_src with --memory-sampling
+    const uint64_t* pos = &sample->time + 1;
+
+    uint64_t data_addr = 0;
+    if (data_objects_)
+    {
+        data_addr = *pos++;
+    }
+    // cpu, res
+    pos++;
+
+    const uint64_t* counter_values = nullptr;
+    if (!last_sample_counters_.empty())
+    {
+        counter_values = pos + 2;
+        pos += pos[0] + 1;
+    }
+
+    const uint64_t* callchain = nullptr;
+    if (record_callgraph_ && !unwinder_)
+    {
+        callchain = pos;
+        pos += pos[0] + 1;
+    }
+
+    const uint64_t* regs = nullptr;
+    const char* stack = nullptr;
+    uint64_t stack_size = 0;
+    if (unwinder_)
+    {
+        // Kernel threads have no user space registers
+        if (*pos++ != PERF_SAMPLE_REGS_ABI_NONE)
+        {
+            regs = pos;
+            pos += DwarfUnwinder::num_sample_regs();
+        }
+        const uint64_t size = *pos++;
+        stack = reinterpret_cast<const char*>(pos);
+        pos += size / sizeof(uint64_t);
+        // dyn_size, the part of the snapshot that is actually filled, only follows if size != 0
+        if (size != 0)
+        {
+            stack_size = *pos++;
+        }
+    }
+
+    uint64_t weight = 0;
+    uint64_t data_src = 0;
+    if (data_objects_)
+    {
+        weight = *pos++;
+        data_src = *pos++;
+    }
+
+    auto& budget = trace_.budget();
+
+    if (budget.degraded(trace::Degradation::DROPPING))
+    {
+        budget.drop();
+        update_sample_counters(counter_values, nullptr);
+        return;
+    }
+
+    LocalCctxNode* node = nullptr;
+    if (!record_callgraph_ || budget.degraded(trace::Degradation::NO_CALLCHAINS))
+    {
+        node = &local_cctx_tree_.cctx_sample(tp, sample->ip);
+    }
+    else if (unwinder_)
     {
-        local_cctx_tree_.cctx_sample(tp, sample->ip);
+        unwind(sample, regs, stack, stack_size);
+        node = &local_cctx_tree_.cctx_sample(tp, unwound_ips_.size(), unwound_ips_.data());
     }
     else
     {
-        local_cctx_tree_.cctx_sample(tp, sample->nr, sample->ips);
+        node = &local_cctx_tree_.cctx_sample(tp, callchain[0], callchain + 1);
     }
-    return false;
+    update_sample_counters(counter_values, node);
+    if (data_objects_)
+    {
+        update_data_accesses(Process(sample->pid), data_addr, weight, data_src, *node);
+    }
+    budget.account(trace::Budget::EVENT_SIZE);
+}
+
+void Writer::unwind(const Reader::RecordSampleType* sample, const uint64_t* regs,
+                    const char* stack, uint64_t stack_size)
+{
+    // Build a callchain in the format of PERF_SAMPLE_CALLCHAIN, so that it is inserted into the
+    // cctx tree the same way
+    unwound_ips_.clear();
+    if ((sample->header.misc & PERF_RECORD_MISC_CPUMODE_MASK) == PERF_RECORD_MISC_KERNEL)
+    {
+        unwound_ips_.emplace_back(PERF_CONTEXT_KERNEL);
+        unwound_ips_.emplace_back(sample->ip);
+    }
+    unwound_ips_.emplace_back(PERF_CONTEXT_USER);
+
+    if (regs == nullptr)
+    {
+        if (unwound_ips_.size() == 1)
+        {
+            unwound_ips_.emplace_back(sample->ip);
+        }
+        return;
+    }
+
+    unwinder_->unwind(Process(sample->pid), Thread(sample->tid), regs, stack, stack_size,
+                      unwound_ips_);
+}
+
+void Writer::update_data_accesses(Process process, uint64_t addr, uint64_t weight,
+                                  uint64_t data_src, LocalCctxNode& node)
+{
+    auto& accesses = node.data_accesses[data_objects_->lookup(process, addr)];
+    accesses.samples++;
+    accesses.weight += weight;
+
+    perf_mem_data_src src;
+    src.val = data_src;
+    if (src.mem_lvl & (PERF_MEM_LVL_LOC_RAM | PERF_MEM_LVL_REM_RAM1 | PERF_MEM_LVL_REM_RAM2))
+    {
+        accesses.dram++;
+    }
+}
+
+void Writer::update_sample_counters(const uint64_t* values, LocalCctxNode* node)
+{
+    if (values == nullptr)
+    {
+        return;
+    }
+
+    if (node != nullptr && node->sample_counters.empty())
+    {
+        node->sample_counters.resize(last_sample_counters_.size(), 0);
+    }
+
+    for (std::size_t i = 0; i < last_sample_counters_.size(); i++)
+    {
+        if (node != nullptr)
+        {
+            node->sample_counters[i] += values[i] - last_sample_counters_[i];
+        }
+        last_sample_counters_[i] = values[i];
+    }
+}
+
+void Writer::adjust_sampling_period(otf2::chrono::time_point tp)
+{
+    if (period_fixed_)
+    {
+        return;
+    }
+
+    if (config().perf.sampling.adaptive_rate != 0 && tp - adapt_window_start_ >= ADAPT_INTERVAL)
+    {
+        adapt_sampling_period(tp);
+    }
+
+    std::uint64_t period = period_;
+    if (trace_.budget().degraded(trace::Degradation::REDUCED_SAMPLING))
+    {
+        period *= trace::Budget::SAMPLING_PERIOD_FACTOR;
+    }
+
+    if (period == current_period_)
+    {
+        return;
+    }
+
+    try
+    {
+        event_.set_sample_period(period);
+    }
+    catch (std::system_error& e)
+    {
+        Log::warn() << "Could not change sampling period for " << scope_.name() << ": "
+                    << e.what();
+        // Don't retry on every sample
+        period_fixed_ = true;
+        return;
+    }
+
+    current_period_ = period;
+
+    sampling_period_event_.timestamp(tp);
+    sampling_period_event_.raw_values()[0] = current_period_;
+    local_cctx_tree_.writer() << sampling_period_event_;
+    trace_.budget().account(trace::Budget::EVENT_SIZE + trace::Budget::METRIC_VALUE_SIZE);
+}
+
+void Writer::adapt_sampling_period(otf2::chrono::time_point tp)
+{
+    const double window = std::chrono::duration<double>(tp - adapt_window_start_).count();
+    const double samples = total_samples - adapt_total_samples_;
+    const bool throttled = throttle_samples != adapt_throttle_samples_;
+    const bool lost = lost_samples != adapt_lost_samples_;
+    const double drain_share =
+        std::chrono::duration<double>(drain_time - adapt_drain_time_).count() / window;
+
+    adapt_window_start_ = tp;
+    adapt_total_samples_ = total_samples;
+    adapt_throttle_samples_ = throttle_samples;
+    adapt_lost_samples_ = lost_samples;
+    adapt_drain_time_ = drain_time;
+
+    // > 1 if we record too many samples and the period has to grow
+    double factor = samples / window / config().perf.sampling.adaptive_rate;
+    if (throttled || lost)
+    {
+        factor = std::max(factor, 2.0);
+    }
+    if (drain_share > MAX_DRAIN_SHARE)
+    {
+        factor = std::max(factor, drain_share / MAX_DRAIN_SHARE);
+    }
+    factor = std::clamp(factor, 1 / MAX_ADAPT_FACTOR, MAX_ADAPT_FACTOR);
+
+    if (std::abs(factor - 1) < ADAPT_TOLERANCE)
+    {
+        return;
+    }
+
+    period_ = std::max(MIN_PERIOD, static_cast<std::uint64_t>(period_ * factor));
+    Log::debug() << "Adaptive sampling: " << samples / window << " samples/s, throttled: "
+                 << throttled << ", lost: " << lost << ", drain share: " << drain_share
+                 << ", new sampling period for " << scope_.name() << ": " << period_;
 }
 
 bool Writer::handle(const RecordMmapType* mmap_event)
 {
+    // The samples before the mmap are unwound with the mappings before it
+    handle_pending_samples();
+
+    // Mappings without PROT_EXEC are only reported with --memory-sampling, they are not
+    // interesting for the function resolvers
+    if (mmap_event->header.misc & PERF_RECORD_MISC_MMAP_DATA)
+    {
+        data_objects_->add_mapping(Process(mmap_event->pid), mmap_event->addr,
+                                   mmap_event->addr + mmap_event->len, mmap_event->pgoff,
+                                   mmap_event->filename);
+        return false;
+    }
+
     // Since this is an mmap record (as opposed to mmap2), it will only be generated for executable
     if (!scope_.is_cpu() && scope_ != ExecutionScope(Thread(mmap_event->tid)))
     {
@@ -121,6 +427,19 @@ bool Writer::handle(const RecordMmapType* mmap_event)
 
     cached_mmap_events_.emplace_back(mmap_event);
 
+    if (unwinder_)
+    {
+        unwinder_->add_mapping(Process(mmap_event->pid), mmap_event->addr,
+                               mmap_event->addr + mmap_event->len, mmap_event->pgoff,
+                               mmap_event->filename);
+    }
+    if (data_objects_)
+    {
+        data_objects_->add_mapping(Process(mmap_event->pid), mmap_event->addr,
+                                   mmap_event->addr + mmap_event->len, mmap_event->pgoff,
+                                   mmap_event->filename);
+    }
+
     return false;
 }
 
@@ -142,11 +461,14 @@ otf2::chrono::time_point Writer::adjust_timepoints(otf2::chrono::time_point tp)
 bool Writer::handle(const Reader::RecordSwitchCpuWideType* context_switch)
 {
     assert(scope_.is_cpu());
+    handle_pending_samples();
+
     auto tp = time_converter_(context_switch->time);
     tp = adjust_timepoints(tp);
 
     update_calling_context(Process(context_switch->pid), Thread(context_switch->tid), tp,
                            context_switch->header.misc & PERF_RECORD_MISC_SWITCH_OUT);
+    trace_.budget().account(trace::Budget::EVENT_SIZE);
 
     return false;
 }
@@ -154,6 +476,8 @@ bool Writer::handle(const Reader::RecordSwitchCpuWideType* context_switch)
 bool Writer::handle(const Reader::RecordSwitchType* context_switch)
 {
     assert(!scope_.is_cpu());
+    handle_pending_samples();
+
     auto tp = time_converter_(context_switch->time);
     tp = adjust_timepoints(tp);
 
@@ -167,6 +491,7 @@ bool Writer::handle(const Reader::RecordSwitchType* context_switch)
         is_switch_out ? -1 : static_cast<std::int64_t>(context_switch->cpu);
 
     local_cctx_tree_.writer() << cpuid_metric_event_;
+    trace_.budget().account(trace::Budget::EVENT_SIZE + trace::Budget::METRIC_VALUE_SIZE);
 
     return false;
 }
@@ -215,6 +540,8 @@ bool Writer::handle(const Reader::RecordCommType* comm)
 
 void Writer::end()
 {
+    handle_pending_samples();
+
     if (!scope_.is_cpu())
     {
         adjust_timepoints(lo2s::time::now());
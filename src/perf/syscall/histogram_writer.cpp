@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <lo2s/perf/syscall/histogram_writer.hpp>
+
+#include <lo2s/measurement_scope.hpp>
+#include <lo2s/perf/counter/metric_writer.hpp>
+#include <lo2s/perf/syscall/common.h>
+#include <lo2s/trace/trace.hpp>
+#include <lo2s/types/thread.hpp>
+
+#include <otf2xx/chrono/time_point.hpp>
+#include <otf2xx/event/metric.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace lo2s::perf::syscall
+{
+HistogramWriter::HistogramWriter(Thread thread, int64_t syscall_nr, trace::Trace& trace)
+: MetricWriter(MeasurementScope::syscall_metric(thread.as_scope()), trace,
+               trace.syscall_metric_class(syscall_nr, SYSCALL_HISTOGRAM_BUCKETS))
+{
+}
+
+void HistogramWriter::write(otf2::chrono::time_point tp, const struct syscall_stats& stats)
+{
+    if (stats.count == last_count_)
+    {
+        return;
+    }
+    last_count_ = stats.count;
+
+    metric_event_.timestamp(tp);
+
+    otf2::event::metric::values& values = metric_event_.raw_values();
+    assert(values.size() == 2 + SYSCALL_HISTOGRAM_BUCKETS);
+
+    values[0] = static_cast<uint64_t>(stats.count);
+    values[1] = static_cast<uint64_t>(stats.time);
+    for (std::size_t bucket = 0; bucket < SYSCALL_HISTOGRAM_BUCKETS; bucket++)
+    {
+        values[2 + bucket] = static_cast<uint64_t>(stats.histogram[bucket]);
+    }
+
+    write_metric_event();
+}
+} // namespace lo2s::perf::syscall
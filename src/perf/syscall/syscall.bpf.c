@@ -0,0 +1,223 @@
+/*
+ * SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// The generated vmlinux.h headers has to go first
+// clang-format off
+#include <vmlinux.h>
+// clang-format on
+
+#include <lo2s/perf/syscall/common.h>
+
+#include <bpf/bpf_helpers.h>
+
+// Is needed to load BPF programs into the kernel
+char LICENSE[] SEC("license") = "GPL";
+
+// Set by lo2s before the program is loaded
+// Minimum duration of a syscall to be submitted
+const volatile u64 min_duration = 0;
+// Only record the threads in the pids map, otherwise all threads but the ones of lo2s
+const volatile bool filter_pids = false;
+// Only record the syscalls enabled in the syscalls map
+const volatile bool filter_syscalls = false;
+// Process id of lo2s, so that the syscalls of lo2s itself are not recorded
+const volatile u32 lo2s_pid = 0;
+// Only accumulate the syscalls in the stats map instead of submitting them
+const volatile bool aggregate = false;
+
+// ring buffer for writing events to lo2s
+struct
+{
+    __uint(type, BPF_MAP_TYPE_RINGBUF);
+    __uint(max_entries, 256 * 1024);
+} rb SEC(".maps");
+
+struct syscall_start
+{
+    u64 time;
+    s64 syscall_nr;
+};
+
+// Syscall currently executed by a thread, from enter to exit. LRU, as threads that exit inside of
+// a syscall leave their entry behind.
+struct
+{
+    __uint(type, BPF_MAP_TYPE_LRU_HASH);
+    __uint(max_entries, 256 * 1024);
+    __type(key, u32);
+    __type(value, struct syscall_start);
+} starts SEC(".maps");
+
+// map containing the threads to record, written from lo2s, read from BPF
+struct
+{
+    __uint(type, BPF_MAP_TYPE_LRU_HASH);
+    __uint(max_entries, 256 * 1024);
+    __type(key, u32);
+    __type(value, char);
+} pids SEC(".maps");
+
+// syscalls to record, indexed by syscall number
+struct
+{
+    __uint(type, BPF_MAP_TYPE_ARRAY);
+    __uint(max_entries, MAX_SYSCALL_NR);
+    __type(key, u32);
+    __type(value, char);
+} syscalls SEC(".maps");
+
+// Statistics per thread and syscall for the aggregated mode, read periodically by lo2s
+struct
+{
+    __uint(type, BPF_MAP_TYPE_LRU_HASH);
+    __uint(max_entries, 64 * 1024);
+    __type(key, struct syscall_stats_key);
+    __type(value, struct syscall_stats);
+} stats SEC(".maps");
+
+// Number of slow syscalls that did not fit into the ring buffer
+struct
+{
+    __uint(type, BPF_MAP_TYPE_ARRAY);
+    __uint(max_entries, 1);
+    __type(key, u32);
+    __type(value, u64);
+} lost SEC(".maps");
+
+static __always_inline bool record_thread(u64 pid_tgid)
+{
+    u32 pid = pid_tgid;
+
+    if (filter_pids)
+    {
+        return bpf_map_lookup_elem(&pids, &pid) != 0;
+    }
+    return (pid_tgid >> 32) != lo2s_pid;
+}
+
+static __always_inline bool record_syscall(s64 syscall_nr)
+{
+    if (!filter_syscalls)
+    {
+        return true;
+    }
+    if (syscall_nr < 0 || syscall_nr >= MAX_SYSCALL_NR)
+    {
+        return false;
+    }
+
+    u32 key = syscall_nr;
+    char* enabled = bpf_map_lookup_elem(&syscalls, &key);
+    return enabled != 0 && *enabled;
+}
+
+static __always_inline u32 log2_u64(u64 v)
+{
+    u32 result = 0;
+    u32 shift = 0;
+
+    shift = (v > 0xFFFFFFFF) << 5;
+    v >>= shift;
+    result = shift;
+    shift = (v > 0xFFFF) << 4;
+    v >>= shift;
+    result |= shift;
+    shift = (v > 0xFF) << 3;
+    v >>= shift;
+    result |= shift;
+    shift = (v > 0xF) << 2;
+    v >>= shift;
+    result |= shift;
+    shift = (v > 0x3) << 1;
+    v >>= shift;
+    result |= shift;
+    result |= (v >> 1);
+
+    return result;
+}
+
+static __always_inline void accumulate(u32 pid, s64 syscall_nr, u64 duration)
+{
+    struct syscall_stats_key key = { .pid = pid, .syscall_nr = syscall_nr };
+
+    struct syscall_stats* entry = bpf_map_lookup_elem(&stats, &key);
+    if (entry == 0)
+    {
+        struct syscall_stats zero = {};
+        bpf_map_update_elem(&stats, &key, &zero, BPF_NOEXIST);
+
+        entry = bpf_map_lookup_elem(&stats, &key);
+        if (entry == 0)
+            return;
+    }
+
+    u32 bucket = log2_u64(duration);
+    if (bucket >= SYSCALL_HISTOGRAM_BUCKETS)
+        bucket = SYSCALL_HISTOGRAM_BUCKETS - 1;
+
+    // Entries are only ever updated by their own thread
+    entry->count++;
+    entry->time += duration;
+    entry->histogram[bucket]++;
+}
+
+SEC("tp/raw_syscalls/sys_enter")
+
+int handle_sys_enter(struct trace_event_raw_sys_enter* ctx)
+{
+    s64 id = ctx->id;
+    u64 pid_tgid = bpf_get_current_pid_tgid();
+
+    if (!record_thread(pid_tgid) || !record_syscall(id))
+        return 0;
+
+    u32 pid = pid_tgid;
+    struct syscall_start start = { .time = bpf_ktime_get_ns(), .syscall_nr = id };
+    bpf_map_update_elem(&starts, &pid, &start, BPF_ANY);
+    return 0;
+}
+
+SEC("tp/raw_syscalls/sys_exit")
+
+int handle_sys_exit(struct trace_event_raw_sys_exit* ctx)
+{
+    u32 pid = bpf_get_current_pid_tgid();
+
+    struct syscall_start* start = bpf_map_lookup_elem(&starts, &pid);
+    if (start == 0)
+        return 0;
+
+    u64 now = bpf_ktime_get_ns();
+    u64 enter_time = start->time;
+    s64 syscall_nr = start->syscall_nr;
+    bpf_map_delete_elem(&starts, &pid);
+
+    if (aggregate)
+    {
+        accumulate(pid, syscall_nr, now - enter_time);
+        return 0;
+    }
+
+    if (now - enter_time < min_duration)
+        return 0;
+
+    struct syscall_event* e = bpf_ringbuf_reserve(&rb, sizeof(*e), 0);
+    if (!e)
+    {
+        u32 key = 0;
+        u64* count = bpf_map_lookup_elem(&lost, &key);
+        if (count)
+            __sync_fetch_and_add(count, 1);
+        return 0;
+    }
+
+    e->pid = pid;
+    e->syscall_nr = syscall_nr;
+    e->enter_time = enter_time;
+    e->exit_time = now;
+    bpf_ringbuf_submit(e, 0);
+    return 0;
+}
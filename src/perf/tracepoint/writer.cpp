@@ -8,6 +8,9 @@
 #include <lo2s/perf/tracepoint/event_attr.hpp>
 #include <lo2s/perf/tracepoint/format.hpp>
 #include <lo2s/perf/tracepoint/reader.hpp>
+#include <lo2s/stream/format.hpp>
+#include <lo2s/stream/stream.hpp>
+#include <lo2s/trace/budget.hpp>
 #include <lo2s/trace/trace.hpp>
 #include <lo2s/types/cpu.hpp>
 
@@ -29,12 +32,22 @@ Writer::Writer(Cpu cpu, const perf::tracepoint::TracepointEventAttr& event, trac
   metric_instance_(
       trace_.metric_instance(metric_class, writer_.location(), trace_.system_tree_cpu_node(cpu))),
   time_converter_(perf::time::Converter::instance()),
-  metric_event_(otf2::chrono::genesis(), metric_instance_)
+  metric_event_(otf2::chrono::genesis(), metric_instance_), budget_(trace_.budget()),
+  stream_(trace_.stream(), stream::SourceType::METRIC,
+          fmt::format("tracepoint {} for {}", event.name(), cpu))
 {
 }
 
 bool Writer::handle(const Reader::RecordSampleType* sample)
 {
+    if (budget_.degraded(trace::Degradation::DROPPING) ||
+        (budget_.degraded(trace::Degradation::DECIMATED_METRICS) &&
+         num_events_++ % trace::Budget::DECIMATION_FACTOR != 0))
+    {
+        budget_.drop();
+        return false;
+    }
+
     metric_event_.timestamp(time_converter_(sample->time));
 
     std::size_t index = 0;
@@ -48,6 +61,8 @@ bool Writer::handle(const Reader::RecordSampleType* sample)
         metric_event_.raw_values()[index++] = sample->raw_data.get(field);
     }
     writer_.write(metric_event_);
+    stream_.metric(metric_event_);
+    budget_.account_metric(index);
     return false;
 }
 } // namespace lo2s::perf::tracepoint
@@ -5,12 +5,18 @@
 #include <lo2s/rb/reader.hpp>
 
 #include <lo2s/rb/events.hpp>
+#include <lo2s/rb/header.hpp>
 #include <lo2s/rb/shm_ringbuf.hpp>
 
+#include <lo2s/shared_memory.hpp>
+
 #include <memory>
 #include <stdexcept>
+#include <system_error>
 
+#include <cerrno>
 #include <cstdint>
+#include <cstring>
 
 extern "C"
 {
@@ -23,39 +29,70 @@ extern "C"
 namespace lo2s
 {
 
-RingbufReader::RingbufReader(clockid_t clockid)
+namespace
+{
+// Creates a ring-buffer with room for at least `pages` normal pages in a new memfd
+std::unique_ptr<ShmRingbuf> create_ringbuf(uint64_t pages, unsigned int memfd_flags)
 {
-    int fd = memfd_create("lo2s", 0);
+    int fd = memfd_create("lo2s", memfd_flags);
     if (fd == -1)
     {
         throw ::std::system_error(errno, std::system_category());
     }
 
-    size_t const pagesize = sysconf(_SC_PAGESIZE);
-    int size = 0;
+    try
+    {
+        // For huge pages, round up to whole huge pages
+        size_t const pagesize = ShmRingbuf::page_size(fd);
+        uint64_t size = pages * sysconf(_SC_PAGESIZE);
+        size = ((size + pagesize - 1) / pagesize) * pagesize;
 
-    int pages = 16;
+        if (ftruncate(fd, size + pagesize) == -1)
+        {
+            throw std::system_error(errno, std::system_category());
+        }
 
-    size = static_cast<int>(pagesize) * pages;
+        // For huge pages, the mmap() fails if there are not enough of them available
+        auto header_map = SharedMemory(fd, pagesize, 0);
 
-    if (ftruncate(fd, size + sysconf(_SC_PAGESIZE)) == -1)
-    {
-        close(fd);
-        throw std::system_error(errno, std::system_category());
-    }
+        auto* first_header = header_map.as<struct ringbuf_header>();
 
-    auto header_map = SharedMemory(fd, sizeof(struct ringbuf_header), 0);
+        memset((void*)first_header, 0, sizeof(struct ringbuf_header));
 
-    auto* first_header = header_map.as<struct ringbuf_header>();
+        first_header->version = RINGBUF_VERSION;
+        first_header->size = size;
+        first_header->tail.store(0);
+        first_header->head.store(0);
 
-    memset((void*)first_header, 0, sizeof(struct ringbuf_header));
+        return std::make_unique<ShmRingbuf>(fd);
+    }
+    catch (...)
+    {
+        close(fd);
+        throw;
+    }
+}
+} // namespace
 
-    first_header->version = RINGBUF_VERSION;
-    first_header->size = size;
-    first_header->tail.store(0);
-    first_header->head.store(0);
+RingbufReader::RingbufReader(clockid_t clockid, uint64_t pages, bool huge_pages)
+{
+    if (huge_pages)
+    {
+        try
+        {
+            rb_ = create_ringbuf(pages, MFD_HUGETLB);
+            huge_pages_ = true;
+        }
+        catch (const std::system_error&)
+        {
+            // No (free) huge pages, fall back to normal pages
+        }
+    }
 
-    rb_ = std::make_unique<ShmRingbuf>(fd);
+    if (!rb_)
+    {
+        rb_ = create_ringbuf(pages, 0);
+    }
     rb_->header()->clockid = clockid;
 }
 
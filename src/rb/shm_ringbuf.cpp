@@ -4,9 +4,13 @@
 
 #include <lo2s/rb/shm_ringbuf.hpp>
 
+#include <lo2s/error.hpp>
+#include <lo2s/numa.hpp>
 #include <lo2s/rb/header.hpp>
+#include <lo2s/shared_memory.hpp>
 #include <lo2s/util.hpp>
 
+#include <algorithm>
 #include <stdexcept>
 #include <string>
 
@@ -14,11 +18,32 @@
 #include <cstddef>
 #include <cstdint>
 
+extern "C"
+{
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+}
+
 namespace lo2s
 {
+size_t ShmRingbuf::page_size(int fd)
+{
+    // On hugetlbfs, the block size is the huge page size. Everything that is mapped has to be
+    // aligned to it.
+    struct stat st; // NOLINT
+    if (fstat(fd, &st) == -1)
+    {
+        throw_errno();
+    }
+    return std::max<size_t>(st.st_blksize, sysconf(_SC_PAGESIZE));
+}
+
 ShmRingbuf::ShmRingbuf(int fd) : fd_(fd)
 {
-    auto header_map = SharedMemory(fd_, sizeof(struct ringbuf_header), 0);
+    size_t const pagesize = page_size(fd_);
+
+    auto header_map = SharedMemory(fd_, pagesize, 0);
 
     size_t const size = header_map.as<struct ringbuf_header>()->size;
 
@@ -38,23 +63,45 @@ ShmRingbuf::ShmRingbuf(int fd) : fd_(fd)
     //
     // in virtual memory:  [ent|-----|ev][ent----|ev]
     //
-    // As there is no way to reserve a range of virtual memory, mmap()-ing two adjacent
-    // ring-buffer without races is tricky. We solve this problem by mmap()-ing an area twice
-    // the size of the ringbuffer and then overwriting the latter half of this mapping with
-    // another mapping of the ringbuffer using MMAP_FIXED. This way we only touch mappings we
-    // control. Also, put the ringbuffer header on a separate page to make life easier.
-
-    size_t const pagesize = sysconf(_SC_PAGESIZE);
+    // As there is no way to reserve a range of virtual memory for a file mapping, mmap()-ing two
+    // adjacent ring-buffer without races is tricky. We solve this problem by reserving an
+    // inaccessible anonymous area of the required size first and then placing both mappings of
+    // the ringbuffer into it using MAP_FIXED. This way we only touch mappings we control, and
+    // can align the area to the (huge) page size. Also, put the ringbuffer header on a separate
+    // page to make life easier.
+
+    size_t const total_size = pagesize + (size * 2);
+
+    auto* reserved = static_cast<std::byte*>(mmap(nullptr, total_size + pagesize, PROT_NONE,
+                                                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                                                  -1, 0));
+    if (reserved == MAP_FAILED)
+    {
+        throw_errno();
+    }
 
-    first_mapping_ = SharedMemory(fd_, (size * 2) + pagesize, 0);
+    auto* start = reinterpret_cast<std::byte*>(
+        (reinterpret_cast<uintptr_t>(reserved) + pagesize - 1) & ~(pagesize - 1));
+    if (start != reserved)
+    {
+        munmap(reserved, start - reserved);
+    }
+    munmap(start + total_size, reserved + pagesize - start);
 
-    second_mapping_ =
-        SharedMemory(fd_, size, pagesize, first_mapping_.as<std::byte>() + size + pagesize);
+    first_mapping_ = SharedMemory(fd_, size + pagesize, 0, start);
+    second_mapping_ = SharedMemory(fd_, size, pagesize, start + size + pagesize);
 
     header_ = first_mapping_.as<struct ringbuf_header>();
     start_ = first_mapping_.as<std::byte>() + pagesize;
 }
 
+void ShmRingbuf::prefer_numa_node(int node)
+{
+    // The second mapping shares the pages of the first one. Huge pages are placed by the policy
+    // of the side that touches them first instead, as hugetlbfs keeps no policy per file.
+    try_prefer_numa_node(first_mapping_.as<void>(), first_mapping_.size(), node);
+}
+
 std::byte* ShmRingbuf::head(size_t ev_size)
 {
     // Always round to the nearest multiple of 8, cause of alignment.
@@ -64,9 +111,10 @@ std::byte* ShmRingbuf::head(size_t ev_size)
     assert(tail % 8 == 0);
     assert(head % 8 == 0);
 
+    // Never fill the ring-buffer completely, as head == tail means that it is empty
     if (head >= tail)
     {
-        if (head + ev_size > tail + header_->size)
+        if (head + ev_size >= tail + header_->size)
         {
             return nullptr;
         }
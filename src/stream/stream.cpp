@@ -0,0 +1,358 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <lo2s/stream/stream.hpp>
+
+#include <lo2s/address.hpp>
+#include <lo2s/calling_context.hpp>
+#include <lo2s/log.hpp>
+#include <lo2s/stream/format.hpp>
+
+#include <otf2xx/chrono/time_point.hpp>
+#include <otf2xx/event/metric.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <fmt/format.h>
+
+extern "C"
+{
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+}
+
+namespace lo2s::stream
+{
+Stream::Stream(const std::string& path)
+{
+    if (path.empty())
+    {
+        return;
+    }
+
+    struct sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+
+    if (path.size() >= sizeof(addr.sun_path))
+    {
+        throw std::runtime_error(fmt::format("Stream socket path '{}' is too long", path));
+    }
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    fd_ = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd_ == -1)
+    {
+        throw std::system_error(errno, std::system_category(), "Could not create stream socket");
+    }
+
+    if (connect(fd_, reinterpret_cast<const struct sockaddr*>(&addr), sizeof(addr)) == -1)
+    {
+        auto err = errno;
+        close(fd_);
+        fd_ = -1;
+        throw std::system_error(err, std::system_category(),
+                                fmt::format("Could not connect to stream consumer at '{}'", path));
+    }
+
+    Log::info() << "Streaming events to: " << path;
+    connected_ = true;
+}
+
+Stream::~Stream()
+{
+    if (dropped_batches_ > 0)
+    {
+        Log::warn() << "The stream consumer could not keep up, " << dropped_batches_
+                    << " event batches were dropped.";
+    }
+
+    if (fd_ != -1)
+    {
+        close(fd_);
+    }
+}
+
+void Stream::submit(const std::byte* batch, std::size_t size)
+{
+    // SOCK_SEQPACKET messages are sent atomically, so concurrent writers need no locking
+    if (send(fd_, batch, size, MSG_DONTWAIT | MSG_NOSIGNAL) != -1)
+    {
+        return;
+    }
+
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS)
+    {
+        dropped_batches_++;
+        return;
+    }
+
+    if (connected_.exchange(false))
+    {
+        Log::warn() << "Lost connection to the stream consumer (" << std::strerror(errno)
+                    << "), disabling streaming.";
+    }
+}
+
+void Stream::add_pending(Writer* writer, std::thread::id thread)
+{
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    pending_[thread].emplace(writer);
+}
+
+void Stream::remove_pending(Writer* writer, std::thread::id thread)
+{
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    auto it = pending_.find(thread);
+    if (it != pending_.end())
+    {
+        it->second.erase(writer);
+    }
+}
+
+std::optional<std::chrono::milliseconds> Stream::flush_due()
+{
+    if (fd_ == -1)
+    {
+        return std::nullopt;
+    }
+
+    std::optional<std::chrono::milliseconds> next_due;
+    std::vector<Writer*> due;
+
+    auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        auto& pending = pending_[std::this_thread::get_id()];
+        for (auto* writer : pending)
+        {
+            auto age = now - writer->batch_start_;
+            if (age >= Writer::FLUSH_INTERVAL)
+            {
+                due.emplace_back(writer);
+                continue;
+            }
+
+            auto next = std::chrono::ceil<std::chrono::milliseconds>(Writer::FLUSH_INTERVAL - age);
+            next_due = next_due ? std::min(*next_due, next) : next;
+        }
+    }
+
+    // flush() removes the writers from pending_, so it must not be locked here
+    for (auto* writer : due)
+    {
+        writer->flush();
+    }
+    return next_due;
+}
+
+void Stream::flush_all()
+{
+    if (fd_ == -1)
+    {
+        return;
+    }
+
+    std::set<Writer*> pending;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        auto it = pending_.find(std::this_thread::get_id());
+        if (it == pending_.end())
+        {
+            return;
+        }
+        pending = std::move(it->second);
+        pending_.erase(it);
+    }
+
+    for (auto* writer : pending)
+    {
+        writer->flush();
+    }
+}
+
+Writer::Writer(Stream& stream, SourceType type, const std::string& name)
+: stream_(stream), source_(stream.register_source()), type_(type), name_(name)
+{
+    if (enabled())
+    {
+        batch_.reserve(MAX_BATCH_SIZE);
+    }
+}
+
+Writer::~Writer()
+{
+    flush();
+}
+
+template <class T>
+T* Writer::append(RecordType type, otf2::chrono::time_point tp, std::size_t payload)
+{
+    const std::size_t size = sizeof(T) + payload;
+
+    if (!batch_.empty() &&
+        (batch_.size() + size > MAX_BATCH_SIZE ||
+         std::chrono::steady_clock::now() - batch_start_ >= FLUSH_INTERVAL))
+    {
+        flush();
+    }
+
+    if (batch_.empty())
+    {
+        batch_.resize(sizeof(batch_header));
+        batch_start_ = std::chrono::steady_clock::now();
+
+        pending_in_ = std::this_thread::get_id();
+        stream_.add_pending(this, *pending_in_);
+
+        if (!source_sent_)
+        {
+            source_sent_ = true;
+
+            auto* source = append<source_record>(RecordType::SOURCE, tp);
+            source->type = static_cast<uint64_t>(type_);
+            name_.copy(source->name, sizeof(source->name) - 1);
+        }
+    }
+
+    if (batch_.size() + size > MAX_BATCH_SIZE)
+    {
+        Log::debug() << "Record of size " << size << " does not fit into a stream batch";
+        return nullptr;
+    }
+
+    auto offset = batch_.size();
+    batch_.resize(offset + size);
+    num_records_++;
+
+    auto* record = reinterpret_cast<T*>(batch_.data() + offset);
+    record->header.type = static_cast<uint32_t>(type);
+    record->header.size = static_cast<uint32_t>(size);
+    record->header.time = tp.time_since_epoch().count();
+
+    return record;
+}
+
+void Writer::cctx(uint64_t ref, uint64_t parent_ref, const CallingContext& cctx)
+{
+    if (!enabled())
+    {
+        return;
+    }
+
+    auto* record = append<cctx_record>(RecordType::CCTX, otf2::chrono::genesis());
+    record->ref = ref;
+    record->parent_ref = parent_ref;
+    record->type = static_cast<uint64_t>(cctx.type);
+
+    switch (cctx.type)
+    {
+    case CallingContextType::PROCESS:
+        record->value = cctx.to_process().as_int();
+        break;
+    case CallingContextType::THREAD:
+        record->value = cctx.to_thread().as_int();
+        break;
+    case CallingContextType::SAMPLE_ADDR:
+        record->value = cctx.to_addr().value();
+        break;
+    case CallingContextType::GPU_KERNEL:
+        record->value = cctx.to_kernel_id();
+        break;
+    case CallingContextType::SYSCALL:
+        record->value = cctx.to_syscall_id();
+        break;
+    default:
+        record->value = 0;
+        break;
+    }
+}
+
+void Writer::cctx_event(RecordType type, otf2::chrono::time_point tp, uint64_t ref)
+{
+    auto* record = append<cctx_event_record>(type, tp);
+    record->ref = ref;
+}
+
+void Writer::metric(const otf2::event::metric& event)
+{
+    if (!enabled())
+    {
+        return;
+    }
+
+    const auto& values = event.raw_values().values();
+    static_assert(sizeof(values[0]) == sizeof(uint64_t));
+
+    auto* record = append<metric_record>(RecordType::METRIC, event.timestamp(),
+                                         values.size() * sizeof(uint64_t));
+    if (record == nullptr)
+    {
+        return;
+    }
+
+    record->num_values = values.size();
+    std::memcpy(reinterpret_cast<std::byte*>(record) + sizeof(metric_record), values.data(),
+                values.size() * sizeof(uint64_t));
+}
+
+void Writer::io(RecordType type, otf2::chrono::time_point tp, uint64_t handle, uint64_t mode,
+                uint64_t bytes, uint64_t matching_id)
+{
+    if (!enabled())
+    {
+        return;
+    }
+
+    auto* record = append<io_record>(type, tp);
+    record->handle = handle;
+    record->mode = mode;
+    record->bytes = bytes;
+    record->matching_id = matching_id;
+}
+
+void Writer::flush()
+{
+    if (pending_in_)
+    {
+        stream_.remove_pending(this, *pending_in_);
+        pending_in_.reset();
+    }
+
+    if (batch_.empty())
+    {
+        return;
+    }
+
+    if (enabled())
+    {
+        auto* header = reinterpret_cast<batch_header*>(batch_.data());
+        header->version = STREAM_VERSION;
+        header->source = source_;
+        header->num_records = num_records_;
+        header->size = batch_.size();
+
+        stream_.submit(batch_.data(), batch_.size());
+    }
+
+    batch_.clear();
+    num_records_ = 0;
+}
+} // namespace lo2s::stream
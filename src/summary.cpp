@@ -11,11 +11,9 @@
 
 #include <array>
 #include <chrono>
-#include <filesystem>
 #include <iomanip>
 #include <iostream>
 #include <mutex>
-#include <numeric>
 #include <sstream>
 #include <string>
 
@@ -35,7 +33,8 @@ Summary& summary()
 }
 
 Summary::Summary()
-: start_wall_time_(std::chrono::steady_clock::now()), num_wakeups_(0), thread_count_(0)
+: start_wall_time_(std::chrono::steady_clock::now()), num_wakeups_(0), thread_count_(0),
+  written_bytes_(0)
 
 {
 }
@@ -93,11 +92,25 @@ void Summary::set_trace_dir(const std::string& trace_dir)
     trace_dir_ = trace_dir;
 }
 
-void Summary::show()
+void Summary::add_written_bytes(std::size_t bytes)
 {
+    written_bytes_ += bytes;
+}
 
-    std::size_t trace_size = 0;
+void Summary::report_trace_size() const
+{
+    if (config().general.quiet)
+    {
+        return;
+    }
 
+    // stderr, so that the report does not get mixed up with the output of the monitored command
+    std::cerr << "[ lo2s: wrote " << pretty_print_bytes(written_bytes_) << " " << trace_dir_
+              << " so far ]\n";
+}
+
+void Summary::show()
+{
     if (config().general.quiet)
     {
         return;
@@ -108,18 +121,6 @@ void Summary::show()
 
     std::chrono::duration<double> const cpu_time = get_cpu_time();
 
-    std::filesystem::recursive_directory_iterator const it(trace_dir_);
-    std::filesystem::recursive_directory_iterator const end;
-
-    trace_size = std::accumulate(
-        it, end, 0, [](std::size_t sum, const std::filesystem::directory_entry& entry) {
-            if (!std::filesystem::is_directory(entry))
-            {
-                return sum + std::filesystem::file_size(entry);
-            }
-            return sum;
-        });
-
     if (config().general.monitor_type == lo2s::MonitorType::PROCESS)
     {
         std::cout << "[ lo2s: ";
@@ -157,7 +158,8 @@ void Summary::show()
 
     if (!trace_dir_.empty())
     {
-        std::cout << "wrote " << pretty_print_bytes(trace_size) << " " << trace_dir_;
+        std::cout << "wrote " << pretty_print_bytes(written_bytes_) << " "
+                  << trace_dir_;
     }
 
     std::cout << " ]\n";
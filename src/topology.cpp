@@ -13,6 +13,7 @@
 #include <string>
 
 #include <cstdint>
+#include <cstdlib>
 
 #include <fmt/format.h>
 
@@ -42,6 +43,24 @@ void Topology::read_proc()
         cpu_to_package_.emplace(Cpu(cpu_id), Package(package_id));
     }
 
+    // Kernels built without CONFIG_NUMA do not have this directory at all. Undocumented-by-design,
+    // the tests fake a NUMA topology by pointing LO2S_TEST_NUMA_SYSFS to a directory like it.
+    const char* test_node_path = std::getenv("LO2S_TEST_NUMA_SYSFS");
+    const std::filesystem::path node_path =
+        test_node_path != nullptr ? test_node_path : "/sys/devices/system/node";
+    for (auto node_id : parse_list_from_file(node_path / "online"))
+    {
+        numa_nodes_.emplace(node_id);
+        for (auto cpu_id : parse_list_from_file(node_path / fmt::format("node{}", node_id) /
+                                                "cpulist"))
+        {
+            if (online.count(cpu_id))
+            {
+                cpu_to_numa_node_.emplace(Cpu(cpu_id), node_id);
+            }
+        }
+    }
+
     std::string line;
     std::ifstream cpuinfo("/proc/cpuinfo");
 
@@ -0,0 +1,156 @@
+// SPDX-FileCopyrightText: 2026 (c) Technische Universität Dresden
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <lo2s/trace/budget.hpp>
+
+#include <lo2s/log.hpp>
+#include <lo2s/time/time.hpp>
+
+#include <otf2xx/chrono/time_point.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+
+namespace lo2s::trace
+{
+namespace
+{
+// Share of the limit (in percent) at which each of the degradation levels kicks in
+constexpr std::array<std::pair<std::size_t, Degradation>, 4> thresholds = {
+    { { 100, Degradation::DROPPING },
+      { 90, Degradation::DECIMATED_METRICS },
+      { 80, Degradation::NO_CALLCHAINS },
+      { 70, Degradation::REDUCED_SAMPLING } }
+};
+} // namespace
+
+std::string to_string(Degradation level)
+{
+    switch (level)
+    {
+    case Degradation::NONE:
+        return "none";
+    case Degradation::REDUCED_SAMPLING:
+        return "reduced sampling frequency";
+    case Degradation::NO_CALLCHAINS:
+        return "no callchains";
+    case Degradation::DECIMATED_METRICS:
+        return "decimated metrics";
+    case Degradation::DROPPING:
+        return "dropping events";
+    }
+    return "unknown";
+}
+
+Budget::Budget(std::size_t max_size, std::size_t max_rate)
+: max_size_(max_size), max_rate_(max_rate),
+  window_start_(std::chrono::steady_clock::now().time_since_epoch().count())
+{
+}
+
+Degradation Budget::level_for(std::size_t used, std::size_t limit) const
+{
+    if (limit == 0)
+    {
+        return Degradation::NONE;
+    }
+
+    for (const auto& threshold : thresholds)
+    {
+        if (used * 100 >= limit * threshold.first)
+        {
+            return threshold.second;
+        }
+    }
+    return Degradation::NONE;
+}
+
+void Budget::update(std::size_t bytes)
+{
+    if (max_size_ != 0)
+    {
+        thread_local std::size_t unchecked = 0;
+
+        unchecked += bytes;
+        if (unchecked >= SIZE_CHECK_INTERVAL)
+        {
+            unchecked = 0;
+            size_level_.store(level_for(written(), max_size_), std::memory_order_relaxed);
+        }
+    }
+
+    Degradation level = size_level_.load(std::memory_order_relaxed);
+
+    if (max_rate_ != 0)
+    {
+        auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+        auto window_start = window_start_.load(std::memory_order_relaxed);
+
+        std::size_t window_written = 0;
+        if (std::chrono::steady_clock::duration(now - window_start) >= std::chrono::seconds(1) &&
+            window_start_.compare_exchange_strong(window_start, now))
+        {
+            window_written_.store(bytes, std::memory_order_relaxed);
+            window_written = bytes;
+        }
+        else
+        {
+            window_written = window_written_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        }
+
+        level = std::max(level, level_for(window_written, max_rate_));
+    }
+
+    if (level == level_.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> const lock(mutex_);
+
+    auto old_level = level_.exchange(level);
+    if (old_level == level)
+    {
+        return;
+    }
+
+    transitions_.emplace_back(lo2s::time::now(), level);
+
+    if (level > old_level)
+    {
+        Log::warn() << "Trace budget: " << written() << " bytes written so far, degrading to: "
+                    << to_string(level);
+    }
+    else
+    {
+        Log::info() << "Trace budget: rate dropped below limit, degradation is now: "
+                    << to_string(level);
+    }
+}
+
+Degradation Budget::max_level() const
+{
+    std::lock_guard<std::mutex> const lock(mutex_);
+
+    Degradation result = Degradation::NONE;
+    for (const auto& transition : transitions_)
+    {
+        result = std::max(result, transition.second);
+    }
+    return result;
+}
+
+std::vector<std::pair<otf2::chrono::time_point, Degradation>> Budget::transitions() const
+{
+    std::lock_guard<std::mutex> const lock(mutex_);
+    return transitions_;
+}
+} // namespace lo2s::trace
@@ -7,8 +7,11 @@
 #include <lo2s/address.hpp>
 #include <lo2s/calling_context.hpp>
 #include <lo2s/config.hpp>
+#include <lo2s/config/dwarf_config.hpp>
+#include <lo2s/debuginfo_prefetch.hpp>
 #include <lo2s/execution_scope.hpp>
 #include <lo2s/execution_scope_group.hpp>
+#include <lo2s/function_resolver.hpp>
 #include <lo2s/line_info.hpp>
 #include <lo2s/local_cctx_tree.hpp>
 #include <lo2s/log.hpp>
@@ -23,6 +26,7 @@
 #include <lo2s/thread_fd_instance.hpp>
 #include <lo2s/time/time.hpp>
 #include <lo2s/topology.hpp>
+#include <lo2s/trace/budget.hpp>
 #include <lo2s/trace/reg_keys.hpp>
 #include <lo2s/types/core.hpp>
 #include <lo2s/types/package.hpp>
@@ -53,34 +57,62 @@
 #include <otf2xx/definition/string.hpp>
 #include <otf2xx/definition/system_tree_node.hpp>
 #include <otf2xx/definition/system_tree_node_domain.hpp>
+#include <otf2xx/event/metric.hpp>
 #include <otf2xx/exception.hpp>
 #include <otf2xx/writer/local.hpp>
 
 #include <chrono>
 #include <filesystem>
+#include <functional>
 #include <map>
 #include <mutex>
 #include <regex>
+#include <set>
 #include <stdexcept>
 #include <string>
+#include <system_error>
 #include <tuple>
 #include <utility>
 #include <vector>
 
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 
 #include <fmt/chrono.h> //NOLINT
 #include <fmt/core.h>
 #include <fmt/format.h>
 
+extern "C"
+{
+#include <otf2/OTF2_Archive.h>
+#include <otf2/OTF2_Callbacks.h>
+}
+
 namespace lo2s::trace
 {
 
 namespace
 {
+OTF2_FlushType pre_flush(void* /*user_data*/, OTF2_FileType /*file_type*/,
+                         OTF2_LocationRef /*location*/, void* /*caller_data*/, bool /*final*/)
+{
+    return OTF2_FLUSH;
+}
+
+OTF2_TimeStamp post_flush(void* user_data, OTF2_FileType file_type, OTF2_LocationRef location)
+{
+    static_cast<Trace*>(user_data)->account_flush(file_type, location);
+    return time::now().time_since_epoch().count();
+}
+
+OTF2_FlushCallbacks flush_callbacks = { pre_flush, post_flush };
+
 std::string get_trace_name()
 {
+    // Number of the current archive when rotating traces
+    static int rotation = 0;
+
     std::string path = config().otf2.trace_path;
     nitro::lang::replace_all(path, "{DATE}", get_datetime());
     nitro::lang::replace_all(path, "{HOSTNAME}", nitro::env::hostname());
@@ -96,8 +128,44 @@ std::string get_trace_name()
         nitro::lang::replace_all(result, it->str(), nitro::env::get((*it)[1]));
     }
 
+    if (config().otf2.rotate_interval.count() != 0 || config().otf2.rotate_size != 0)
+    {
+        result = fmt::format("{}_{:04}", result, rotation++);
+    }
+
     return result;
 }
+
+// Appends the binaries that contain the sampled addresses below node to binaries, in the order in
+// which merge_nodes() resolves them
+void collect_sampled_binaries(const LocalCctxMap::value_type& node, Resolvers& resolvers,
+                              Process process, std::set<const FunctionResolver*>& seen,
+                              std::vector<std::string>& binaries)
+{
+    for (const auto& child : node.second.children)
+    {
+        if (child.first.type == CallingContextType::PROCESS)
+        {
+            process = child.first.to_process();
+        }
+        else if (child.first.type == CallingContextType::SAMPLE_ADDR)
+        {
+            auto fr = resolvers.function_resolvers.find(process);
+            if (fr != resolvers.function_resolvers.end())
+            {
+                auto it = fr->second.find(child.first.to_addr());
+                // Only the binaries that have not been loaded yet, not kallsyms or perf maps
+                if (it != fr->second.end() && seen.emplace(it->second.get()).second &&
+                    dynamic_cast<const LazyFunctionResolver*>(it->second.get()) != nullptr)
+                {
+                    binaries.emplace_back(it->second->name());
+                }
+            }
+        }
+
+        collect_sampled_binaries(child, resolvers, process, seen, binaries);
+    }
+}
 } // namespace
 
 Trace::Trace()
@@ -122,11 +190,20 @@ Trace::Trace()
       otf2::common::group_flag_type::none)),
   system_tree_root_node_(registry_.create<otf2::definition::system_tree_node>(
       intern(nitro::env::hostname()), intern("machine"))),
-  groups_(ExecutionScopeGroup::instance())
+  groups_(ExecutionScopeGroup::instance()),
+  budget_(config().otf2.max_trace_size, config().otf2.max_trace_rate),
+  stream_(config().otf2.stream_path)
 {
     Log::info() << "Using trace directory: " << trace_name_;
     summary().set_trace_dir(trace_name_);
 
+    // The bytes written to the archive are counted as its buffers are flushed, so that the trace
+    // size is known without looking at every file of the archive afterwards
+    if (OTF2_Archive_SetFlushCallbacks(archive_.get(), &flush_callbacks, this) != OTF2_SUCCESS)
+    {
+        Log::warn() << "Can not account the size of the written trace";
+    }
+
     archive_.set_creator(std::string("lo2s - ") + lo2s::version());
     archive_.set_description(config().general.lo2s_command_line);
 
@@ -252,6 +329,41 @@ void Trace::end_record()
     Log::info() << "Recording done. Start finalization...";
 }
 
+void Trace::account_flush(int file_type, std::uint64_t location)
+{
+    std::filesystem::path file;
+    switch (file_type)
+    {
+    case OTF2_FILETYPE_EVENTS:
+        file = std::filesystem::path(trace_name_) / "traces" / fmt::format("{}.evt", location);
+        break;
+    case OTF2_FILETYPE_LOCAL_DEFS:
+        file = std::filesystem::path(trace_name_) / "traces" / fmt::format("{}.def", location);
+        break;
+    case OTF2_FILETYPE_GLOBAL_DEFS:
+        file = std::filesystem::path(trace_name_) / "traces.def";
+        break;
+    default:
+        return;
+    }
+
+    // Only the file that was just flushed is looked at, once per full buffer
+    std::error_code ec;
+    std::size_t const size = std::filesystem::file_size(file, ec);
+    if (ec)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> const lock(flushed_sizes_mutex_);
+    auto& flushed_size = flushed_sizes_[{ file_type, location }];
+    if (size > flushed_size)
+    {
+        summary().add_written_bytes(size - flushed_size);
+        flushed_size = size;
+    }
+}
+
 otf2::chrono::time_point Trace::record_from() const
 {
     return starting_time_;
@@ -521,6 +633,8 @@ otf2::writer::local& Trace::syscall_writer(const ExecutionScope& scope)
 
 otf2::writer::local& Trace::metric_writer(const MeasurementScope& writer_scope)
 {
+    std::lock_guard<std::recursive_mutex> const guard(mutex_);
+
     const auto& intern_location = registry_.emplace<otf2::definition::location>(
         ByMeasurementScope(writer_scope), intern(writer_scope.name()),
         registry_.get<otf2::definition::location_group>(
@@ -569,6 +683,8 @@ otf2::writer::local& Trace::posix_io_writer(Thread thread)
 
 otf2::writer::local& Trace::create_metric_writer(const std::string& name)
 {
+    std::lock_guard<std::recursive_mutex> const guard(mutex_);
+
     const auto& location = registry_.create<otf2::definition::location>(
         intern(name),
         registry_.get<otf2::definition::location_group>(
@@ -674,6 +790,8 @@ Trace::metric_instance(const otf2::definition::metric_class& metric_class,
                        const otf2::definition::location& recorder,
                        const otf2::definition::location& scope)
 {
+    std::lock_guard<std::recursive_mutex> const guard(mutex_);
+
     return registry_.create<otf2::definition::metric_instance>(metric_class, recorder, scope);
 }
 
@@ -682,9 +800,17 @@ Trace::metric_instance(const otf2::definition::metric_class& metric_class,
                        const otf2::definition::location& recorder,
                        const otf2::definition::system_tree_node& scope)
 {
+    std::lock_guard<std::recursive_mutex> const guard(mutex_);
+
     return registry_.create<otf2::definition::metric_instance>(metric_class, recorder, scope);
 }
 
+otf2::common::metric_mode Trace::perf_metric_mode() const
+{
+    return config().perf.metric_deltas ? otf2::common::metric_mode::accumulated_last :
+                                         otf2::common::metric_mode::accumulated_start;
+}
+
 otf2::definition::metric_class&
 Trace::tracepoint_metric_class(const perf::tracepoint::TracepointEventAttr& event)
 {
@@ -708,6 +834,40 @@ Trace::tracepoint_metric_class(const perf::tracepoint::TracepointEventAttr& even
     return registry_.get<otf2::definition::metric_class>(ByString(event.name()));
 }
 
+otf2::definition::metric_class& Trace::syscall_metric_class(int64_t syscall_nr,
+                                                            std::size_t histogram_buckets)
+{
+    std::lock_guard<std::recursive_mutex> const guard(mutex_);
+
+    const auto syscall_name = syscall_name_for_nr(syscall_nr);
+    auto key = ByString(fmt::format("syscall::{}", syscall_name));
+    if (registry_.has<otf2::definition::metric_class>(key))
+    {
+        return registry_.get<otf2::definition::metric_class>(key);
+    }
+
+    auto& mc = registry_.create<otf2::definition::metric_class>(
+        key, otf2::common::metric_occurence::async, otf2::common::recorder_kind::abstract);
+
+    mc.add_member(metric_member(fmt::format("{}::count", syscall_name),
+                                fmt::format("Number of {} syscalls", syscall_name),
+                                otf2::common::metric_mode::accumulated_start,
+                                otf2::common::type::uint64, "#"));
+    mc.add_member(metric_member(fmt::format("{}::time", syscall_name),
+                                fmt::format("Total time spent in {} syscalls", syscall_name),
+                                otf2::common::metric_mode::accumulated_start,
+                                otf2::common::type::uint64, "s", -9));
+    for (std::size_t bucket = 0; bucket < histogram_buckets; bucket++)
+    {
+        mc.add_member(metric_member(
+            fmt::format("{}::latency[{}]", syscall_name, bucket),
+            fmt::format("Number of {} syscalls that took [2^{}, 2^{}) ns", syscall_name, bucket,
+                        bucket + 1),
+            otf2::common::metric_mode::accumulated_start, otf2::common::type::uint64, "#"));
+    }
+    return mc;
+}
+
 otf2::definition::metric_class& Trace::metric_class()
 {
     return registry_.create<otf2::definition::metric_class>(otf2::common::metric_occurence::async,
@@ -817,7 +977,7 @@ otf2::definition::calling_context& Trace::cctx_for_address(Address addr, Resolve
         intern_region(line_info), intern_scl(line_info), *global_node->second.cctx);
 
     registry_.create<otf2::definition::calling_context_property>(
-        new_cctx, intern("ip"), otf2::attribute_value(intern(std::to_string(addr.value()))));
+        new_cctx, intern("ip"), otf2::attribute_value(static_cast<std::uint64_t>(addr.value())));
 
     return new_cctx;
 }
@@ -944,6 +1104,22 @@ void Trace::merge_nodes(const std::map<CallingContext, LocalCctxNode>::value_typ
         // Write a mapping local cctx reference number -> global reference number
         mapping_table.at(local_child.second.ref) = global_child->second.cctx->ref();
 
+        const auto& local_counters = local_child.second.sample_counters;
+        auto& global_counters = global_child->second.sample_counters;
+        if (global_counters.size() < local_counters.size())
+        {
+            global_counters.resize(local_counters.size(), 0);
+        }
+        for (std::size_t i = 0; i < local_counters.size(); i++)
+        {
+            global_counters[i] += local_counters[i];
+        }
+
+        for (const auto& accesses : local_child.second.data_accesses)
+        {
+            global_child->second.data_accesses[accesses.first] += accesses.second;
+        }
+
         // If we later want to resolve addresses, we need to know in which process we are,
         // so if we are currently in a Process node, save the Process for later use.
         if (global_child->first.type == CallingContextType::PROCESS)
@@ -980,6 +1156,34 @@ otf2::definition::mapping_table Trace::merge_calling_contexts(const LocalCctxTre
     return { otf2::definition::mapping_table::mapping_type_type::calling_context, mappings };
 }
 
+void Trace::write_sample_properties(const GlobalCctxMap::value_type& node)
+{
+    const auto& counters = config().perf.sampling.counters;
+    for (const auto& child : node.second.children)
+    {
+        for (std::size_t i = 0; i < child.second.sample_counters.size(); i++)
+        {
+            registry_.create<otf2::definition::calling_context_property>(
+                *child.second.cctx, intern("counter::" + counters.at(i)),
+                otf2::attribute_value(child.second.sample_counters[i]));
+        }
+        for (const auto& accesses : child.second.data_accesses)
+        {
+            const auto prefix = "data::" + accesses.first + "::";
+            registry_.create<otf2::definition::calling_context_property>(
+                *child.second.cctx, intern(prefix + "samples"),
+                otf2::attribute_value(accesses.second.samples));
+            registry_.create<otf2::definition::calling_context_property>(
+                *child.second.cctx, intern(prefix + "weight"),
+                otf2::attribute_value(accesses.second.weight));
+            registry_.create<otf2::definition::calling_context_property>(
+                *child.second.cctx, intern(prefix + "dram"),
+                otf2::attribute_value(accesses.second.dram));
+        }
+        write_sample_properties(child);
+    }
+}
+
 otf2::definition::calling_context& Trace::cctx_for_syscall(int64_t syscall_id)
 {
     const auto& syscall_name = intern_syscall_str(syscall_id);
@@ -1103,6 +1307,8 @@ const otf2::definition::source_code_location& Trace::intern_scl(const LineInfo&
 
 const otf2::definition::region& Trace::intern_region(const LineInfo& info)
 {
+    intern_all({ &info.function, &info.file, &info.dso });
+
     const auto& name_str = intern(info.function);
     const auto& region = registry_.emplace<otf2::definition::region>(
         ByLineInfo(info), name_str, name_str, name_str, otf2::common::role_type::function,
@@ -1122,11 +1328,65 @@ const otf2::definition::region& Trace::intern_region(const LineInfo& info)
     return region;
 }
 
+Trace::InternShard& Trace::intern_shard(const std::string& name)
+{
+    return intern_shards_[std::hash<std::string>{}(name) % INTERN_SHARDS];
+}
+
+const otf2::definition::string* Trace::lookup_interned(InternShard& shard, const std::string& name)
+{
+    std::lock_guard<std::mutex> const guard(shard.mutex);
+
+    auto it = shard.strings.find(name);
+    if (it == shard.strings.end())
+    {
+        return nullptr;
+    }
+    return it->second;
+}
+
 const otf2::definition::string& Trace::intern(const std::string& name)
 {
+    auto& shard = intern_shard(name);
+
+    const auto* interned = lookup_interned(shard, name);
+    if (interned != nullptr)
+    {
+        return *interned;
+    }
+
+    // Never acquire mutex_ while holding a shard lock, intern() is called with mutex_ held.
     std::lock_guard<std::recursive_mutex> const guard(mutex_);
 
-    return registry_.emplace<otf2::definition::string>(ByString(name), name);
+    const auto& str = registry_.emplace<otf2::definition::string>(ByString(name), name);
+    budget_.account(Budget::EVENT_SIZE + name.size());
+
+    std::lock_guard<std::mutex> const shard_guard(shard.mutex);
+    shard.strings.emplace(name, &str);
+    return str;
+}
+
+void Trace::intern_all(std::initializer_list<const std::string*> names)
+{
+    std::vector<const std::string*> missing;
+    for (const auto* name : names)
+    {
+        if (lookup_interned(intern_shard(*name), *name) == nullptr)
+        {
+            missing.emplace_back(name);
+        }
+    }
+
+    if (missing.empty())
+    {
+        return;
+    }
+
+    std::lock_guard<std::recursive_mutex> const guard(mutex_);
+    for (const auto* name : missing)
+    {
+        intern(*name);
+    }
 }
 
 LocalCctxTree& Trace::create_local_cctx_tree(const MeasurementScope& scope)
@@ -1138,8 +1398,61 @@ LocalCctxTree& Trace::create_local_cctx_tree(const MeasurementScope& scope)
     return local_cctx_trees_.emplace_back(*this, scope);
 }
 
+void Trace::write_budget_degradations()
+{
+    if (!budget_.enabled())
+    {
+        return;
+    }
+
+    add_lo2s_property("TRACE_BUDGET::ESTIMATED_SIZE", std::to_string(budget_.written()));
+    add_lo2s_property("TRACE_BUDGET::DROPPED_EVENTS", std::to_string(budget_.dropped()));
+    add_lo2s_property("TRACE_BUDGET::MAX_DEGRADATION", to_string(budget_.max_level()));
+
+    auto transitions = budget_.transitions();
+    if (transitions.empty())
+    {
+        return;
+    }
+
+    Log::warn() << "lo2s reduced the recorded data to stay within the trace budget, "
+                << budget_.dropped() << " events were dropped. See the \"lo2s trace budget\" "
+                << "metric in the trace for details.";
+
+    auto& writer = create_metric_writer("lo2s trace budget");
+    auto mc = otf2::definition::make_weak_ref(metric_class());
+    mc->add_member(metric_member("degradation", "Degradation level of the trace output",
+                                 otf2::common::metric_mode::absolute_point,
+                                 otf2::common::type::int64, "level"));
+
+    otf2::event::metric event(otf2::chrono::genesis(),
+                              metric_instance(*mc, writer.location(), system_tree_root_node_));
+
+    for (const auto& transition : transitions)
+    {
+        event.timestamp(transition.first);
+        event.raw_values()[0] = static_cast<std::int64_t>(transition.second);
+        writer.write(event);
+    }
+}
+
 void Trace::finalize(Resolvers& resolvers)
 {
+    write_budget_degradations();
+
+    // Download the debug information of the sampled binaries in the background, while the binaries
+    // that are available already are resolved
+    if (config().dwarf.usage == DwarfUsage::FULL)
+    {
+        std::vector<std::string> binaries;
+        std::set<const FunctionResolver*> seen;
+        for (const auto& local_cctx : local_cctx_trees_)
+        {
+            collect_sampled_binaries(local_cctx.get_tree(), resolvers, Process(), seen, binaries);
+        }
+        DebuginfoPrefetcher::instance().prefetch(binaries);
+    }
+
     for (auto& local_cctx : local_cctx_trees_)
     {
         if (local_cctx.num_cctx() > 0)
@@ -1148,6 +1461,7 @@ void Trace::finalize(Resolvers& resolvers)
             local_cctx.writer() << mapping;
         }
     }
+    write_sample_properties(calling_context_tree_);
     for (auto& thread : thread_names_)
     {
         if (!registry_.has<otf2::definition::calling_context>(ByThread(thread.first)))